@@ -81,8 +81,7 @@ TEST(BacktrackingPartial, sky7_medium_partial)
               sky7_medium_partial.result);
 }
 
-// ~1100ms
-TEST(BacktrackingPartial, DISABLED_sky7_hard_partial)
+TEST(BacktrackingPartial, sky7_hard_partial)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky7_hard_partial.clues,
                                         sky7_hard_partial.board,
@@ -106,7 +105,7 @@ TEST(BacktrackingPartial, sky8_medium_partial)
               sky8_medium_partial.result);
 }
 
-TEST(BacktrackingPartial, DISABLED_sky8_hard_partial)
+TEST(BacktrackingPartial, sky8_hard_partial)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky8_hard_partial.clues,
                                         sky8_hard_partial.board,
@@ -163,8 +162,7 @@ TEST(BacktrackingPartial, sky11_medium_partial)
               sky11_medium_partial.result);
 }
 
-// takes forever
-TEST(BacktrackingPartial, DISABLED_sky11_medium_partial_2)
+TEST(BacktrackingPartial, sky11_medium_partial_2)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky11_medium_partial_2.clues,
                                         sky11_medium_partial_2.board,
@@ -37,12 +37,12 @@ TEST(Backtracking, sky6_easy)
     EXPECT_EQ(backtracking::SolvePuzzle(sky6_easy.clues), sky6_easy.result);
 }
 
-TEST(Backtracking, DISABLED_sky6_medium)
+TEST(Backtracking, sky6_medium)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky6_medium.clues), sky6_medium.result);
 }
 
-TEST(Backtracking, DISABLED_sky6_hard)
+TEST(Backtracking, sky6_hard)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky6_hard.clues), sky6_hard.result);
 }
@@ -57,7 +57,7 @@ TEST(Backtracking, sky6_random)
     EXPECT_EQ(backtracking::SolvePuzzle(sky6_random.clues), sky6_random.result);
 }
 
-TEST(Backtracking, DISABLED_sky6_random_2)
+TEST(Backtracking, sky6_random_2)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky6_random_2.clues),
               sky6_random_2.result);
@@ -69,7 +69,7 @@ TEST(Backtracking, sky6_random_3)
               sky6_random_3.result);
 }
 
-TEST(Backtracking, DISABLED_sky7_medium)
+TEST(Backtracking, sky7_medium)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky7_medium.clues), sky7_medium.result);
 }
@@ -79,13 +79,13 @@ TEST(Backtracking, sky7_hard)
     EXPECT_EQ(backtracking::SolvePuzzle(sky7_hard.clues), sky7_hard.result);
 }
 
-TEST(Backtracking, DISABLED_sky7_very_hard)
+TEST(Backtracking, sky7_very_hard)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky7_very_hard.clues),
               sky7_very_hard.result);
 }
 
-TEST(Backtracking, DISABLED_sky7_random)
+TEST(Backtracking, sky7_random)
 {
     EXPECT_EQ(backtracking::SolvePuzzle(sky7_random.clues), sky7_random.result);
 }
@@ -1,3 +1,6 @@
+// first, the other headers pull in testing::Field which clashes with Field
+#include "shared/tst_sharedtest.h"
+
 #include "backtracking/tst_backtracking_partialtest.h"
 #include "backtracking/tst_backtrackingtest.h"
 #include "permutation/tst_permutation_partialtest.h"
@@ -65,8 +65,7 @@ TEST(PermutationPartial, sky7_easy_partial)
               sky7_easy_partial.result);
 }
 
-// ??? takes too long why?
-TEST(PermutationPartial, DISABLED_sky7_easy_partial_2)
+TEST(PermutationPartial, sky7_easy_partial_2)
 {
     EXPECT_EQ(permutation::SolvePuzzle(sky7_easy_partial_2.clues,
                                        sky7_easy_partial_2.board,
@@ -7,7 +7,22 @@
 #include "../test_skyscraper_provider.h"
 
 #include "../../Skyscrapers/permutation.h"
+#include "../../Skyscrapers/permutation/cluepair.h"
+#include "../../Skyscrapers/permutation/mdd.h"
+#include "../../Skyscrapers/permutation/permutationfilter.h"
+#include "../../Skyscrapers/permutation/permutationtable.h"
+#include "../../Skyscrapers/permutation/slice.h"
+#include "../../Skyscrapers/permutation/sparsebitset.h"
+#include "../../Skyscrapers/permutation/tablefile.h"
+#include "../../Skyscrapers/shared/board.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 using namespace testing;
@@ -32,6 +47,11 @@ TEST(Permutation, sky4_hard_2)
     EXPECT_EQ(permutation::SolvePuzzle(sky4_hard_2.clues), sky4_hard_2.result);
 }
 
+TEST(Permutation, sky5_sparse)
+{
+    EXPECT_EQ(permutation::SolvePuzzle(sky5_sparse.clues), sky5_sparse.result);
+}
+
 TEST(Permutation, sky6_easy)
 {
     EXPECT_EQ(permutation::SolvePuzzle(sky6_easy.clues), sky6_easy.result);
@@ -90,4 +110,291 @@ TEST(Permutation, sky7_random)
     EXPECT_EQ(permutation::SolvePuzzle(sky7_random.clues), sky7_random.result);
 }
 
+TEST(Permutation, rejects_sizes_above_max_board_size)
+{
+    std::vector<int> clues((maxBoardSize + 1) * 4, 0);
+    EXPECT_THROW(permutation::SolvePuzzle(clues), std::invalid_argument);
+}
+
+TEST(PermutationTable, permutationCount_fits_to_permutations)
+{
+    for (std::size_t size = 1; size <= 8; ++size) {
+        const auto &table = permutation::PermutationTable::forSize(size);
+        for (int front = 0; front <= static_cast<int>(size); ++front) {
+            for (int back = 0; back <= static_cast<int>(size); ++back) {
+                permutation::CluePair cluePair{front, back};
+                if (cluePair.isEmpty()) {
+                    continue;
+                }
+                EXPECT_EQ(table.permutationCount(cluePair),
+                          table.permutations(cluePair).count())
+                    << size << " " << front << " " << back;
+            }
+        }
+    }
+    EXPECT_EQ(permutation::PermutationTable::forSize(7).permutationCount(
+                  permutation::CluePair{0, 0}),
+              5040u);
+}
+
+TEST(PermutationTable, mdd_fits_to_permutations)
+{
+    std::size_t size = 6;
+    const auto &table = permutation::PermutationTable::forSize(size);
+    permutation::MddScratch scratch;
+
+    for (int front = 0; front <= static_cast<int>(size); ++front) {
+        for (int back = 0; back <= static_cast<int>(size); ++back) {
+            permutation::CluePair cluePair{front, back};
+            if (cluePair.isEmpty()) {
+                continue;
+            }
+            auto permutations = table.permutations(cluePair);
+            auto mdd = table.mdd(cluePair);
+            ASSERT_TRUE(mdd);
+            EXPECT_EQ(mdd.permutationCount(), permutations.count());
+
+            // field 0 without value 1, field 2 only with 2 or 3
+            RowMasks domains{};
+            domains.fill(fullBitmask(size));
+            domains[0] &= static_cast<BitmaskType>(~valueBitmask(1));
+            domains[2] = valueBitmask(2) | valueBitmask(3);
+
+            RowMasks expected{};
+            std::uint64_t expectedCount = 0;
+            for (std::size_t perm = 0; perm < permutations.count(); ++perm) {
+                bool fits = true;
+                for (std::size_t idx = 0; idx < size; ++idx) {
+                    auto value = permutations.value(
+                        static_cast<permutation::PermutationIndex>(perm),
+                        idx);
+                    fits = fits && (domains[idx] & valueBitmask(value)) != 0;
+                }
+                if (!fits) {
+                    continue;
+                }
+                ++expectedCount;
+                for (std::size_t idx = 0; idx < size; ++idx) {
+                    expected[idx] |= valueBitmask(permutations.value(
+                        static_cast<permutation::PermutationIndex>(perm),
+                        idx));
+                }
+            }
+            RowMasks supported;
+            EXPECT_EQ(mdd.supportedValues(domains, supported, scratch),
+                      expectedCount);
+            EXPECT_EQ(supported, expected) << front << " " << back;
+        }
+    }
+}
+
+TEST(PermutationFilter, fits_to_plain_loop)
+{
+    std::size_t size = 7;
+    std::mt19937 random{42};
+    const auto &table = permutation::PermutationTable::forSize(size);
+    auto permutations = table.permutations(permutation::CluePair{2, 0});
+    ASSERT_GE(permutations.count(), 100u);
+
+    // every count up to 100 so all tails of a vectorized filter are covered
+    for (std::size_t count = 0; count <= 100; ++count) {
+        for (bool reversed : {false, true}) {
+            permutation::PermutationList permutationList{
+                permutations.words(), count, size, reversed};
+
+            RowMasks allowed{};
+            for (std::size_t idx = 0; idx < size; ++idx) {
+                allowed[idx] = fullBitmask(size);
+                for (int value = 1; value <= static_cast<int>(size);
+                     ++value) {
+                    if (random() % 5 == 0) {
+                        allowed[idx] &=
+                            static_cast<BitmaskType>(~valueBitmask(value));
+                    }
+                }
+            }
+
+            std::vector<std::uint64_t> expected((count + 63) / 64, 0);
+            for (std::size_t perm = 0; perm < count; ++perm) {
+                bool fits = true;
+                for (std::size_t idx = 0; idx < size; ++idx) {
+                    auto value = permutationList.value(
+                        static_cast<permutation::PermutationIndex>(perm),
+                        idx);
+                    fits = fits && (allowed[idx] & valueBitmask(value)) !=
+                                       BitmaskType{};
+                }
+                if (fits) {
+                    expected[perm / 64] |= std::uint64_t{1} << (perm % 64);
+                }
+            }
+
+            std::vector<std::uint64_t> survivors;
+            permutation::filterPermutations(permutationList, allowed,
+                                            survivors);
+            EXPECT_EQ(survivors, expected) << count << " " << reversed;
+        }
+    }
+}
+
+// field idx of the first row of board gets count values starting at
+// idx + 1, wrapping around behind size
+inline void narrowFirstRow(Board &board, int count, int countOfFirstField)
+{
+    auto size = board.size();
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto bitmask = static_cast<BitmaskType>(~fullBitmask(size));
+        for (int i = 0; i < (idx == 0 ? countOfFirstField : count); ++i) {
+            bitmask |= valueBitmask(static_cast<int>((idx + i) % size) + 1);
+        }
+        EXPECT_TRUE(board.setField(idx, ::Field{bitmask}));
+    }
+}
+
+TEST(Slice, row_without_clues_generated_from_fields)
+{
+    std::size_t size = 6;
+    // 4^6 = 4096 combinations, just within maxFieldPermutations
+    Board board{size};
+    narrowFirstRow(board, 4, 4);
+    auto &row = board.mRows[size];
+    auto domains = row.fieldMasks();
+
+    std::uint64_t expectedCount = 0;
+    RowMasks expected{};
+    std::vector<int> values{1, 2, 3, 4, 5, 6};
+    do {
+        bool fits = true;
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            fits = fits &&
+                   (domains[idx] & valueBitmask(values[idx])) != BitmaskType{};
+        }
+        if (!fits) {
+            continue;
+        }
+        ++expectedCount;
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            expected[idx] |= valueBitmask(values[idx]);
+        }
+    } while (std::next_permutation(values.begin(), values.end()));
+    ASSERT_GT(expectedCount, 0u);
+
+    permutation::Slice slice{row};
+    EXPECT_FALSE(slice.hasPermutations());
+    EXPECT_TRUE(slice.solveFromPossiblePermutations(size));
+    EXPECT_TRUE(slice.hasPermutations());
+    EXPECT_EQ(slice.permutationCount(), expectedCount);
+    auto masks = row.fieldMasks();
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        EXPECT_EQ(masks[idx] & fullBitmask(size), expected[idx]) << idx;
+    }
+}
+
+TEST(Slice, row_without_clues_too_wide_to_generate)
+{
+    std::size_t size = 6;
+    // 5 * 4^5 = 5120 combinations, above maxFieldPermutations
+    Board board{size};
+    narrowFirstRow(board, 4, 5);
+    auto &row = board.mRows[size];
+    auto domains = row.fieldMasks();
+
+    permutation::Slice slice{row};
+    EXPECT_TRUE(slice.solveFromPossiblePermutations(size));
+    EXPECT_FALSE(slice.hasPermutations());
+    EXPECT_EQ(slice.permutationCount(), 0u);
+    EXPECT_FALSE(slice.isDirty());
+    EXPECT_EQ(row.fieldMasks(), domains);
+}
+
+TEST(SparseBitset, intersect_with_mask)
+{
+    permutation::SparseBitset bitset{130};
+    EXPECT_FALSE(bitset.isEmpty());
+    EXPECT_EQ(bitset.wordCount(), 3u);
+    EXPECT_EQ(bitset.count(), 130u);
+    EXPECT_EQ(bitset.word(2), 3u);
+
+    // keep bit 0, 64 and 129
+    std::vector<std::uint64_t> first{1, 1, 0};
+    std::vector<std::uint64_t> second{0, 0, 2};
+    bitset.clearMask();
+    bitset.addToMask(first.data());
+    bitset.addToMask(second.data());
+    bitset.intersectWithMask();
+    EXPECT_EQ(bitset.count(), 3u);
+    EXPECT_EQ(bitset.word(0), 1u);
+    EXPECT_EQ(bitset.word(1), 1u);
+    EXPECT_EQ(bitset.word(2), 2u);
+
+    EXPECT_EQ(bitset.intersectIndex(second.data()), 2);
+    std::vector<std::uint64_t> none{2, 2, 1};
+    EXPECT_EQ(bitset.intersectIndex(none.data()), -1);
+
+    // remove bit 64, the empty word is not visited anymore
+    std::vector<std::uint64_t> removed{0, 1, 0};
+    bitset.clearMask();
+    bitset.addToMask(removed.data());
+    bitset.reverseMask();
+    bitset.intersectWithMask();
+    EXPECT_EQ(bitset.count(), 2u);
+    EXPECT_EQ(bitset.word(1), 0u);
+    EXPECT_EQ(bitset.intersectIndex(first.data()), 0);
+
+    bitset.clearMask();
+    bitset.intersectWithMask();
+    EXPECT_TRUE(bitset.isEmpty());
+    EXPECT_EQ(bitset.count(), 0u);
+}
+
+#if defined(__unix__) || defined(__APPLE__)
+TEST(TableFile, write_and_open)
+{
+    auto directory = std::filesystem::temp_directory_path() /
+                     ("skyscrapers_tablefile_" +
+                      std::to_string(std::random_device{}()));
+    std::filesystem::create_directories(directory);
+
+    std::vector<permutation::PermutationWord> words{1, 2, 3, 5, 8, 13};
+    ASSERT_TRUE(
+        permutation::writeTableFile(directory.string(), 5, 2, 3, words));
+
+    {
+        permutation::MappedTableFile file;
+        ASSERT_TRUE(file.open(directory.string(), 5, 2, 3));
+        ASSERT_EQ(file.wordCount(), words.size());
+        EXPECT_TRUE(std::equal(words.begin(), words.end(), file.words()));
+    }
+
+    // a file of another bucket is not taken
+    auto path = directory / "permutations_5_2_3.bin";
+    std::filesystem::copy_file(path, directory / "permutations_5_3_2.bin");
+    {
+        permutation::MappedTableFile file;
+        EXPECT_FALSE(file.open(directory.string(), 5, 3, 2));
+        EXPECT_EQ(file.wordCount(), 0u);
+    }
+
+    auto overwriteByte = [&](std::streamoff offset) {
+        std::fstream stream{path, std::ios::in | std::ios::out |
+                                      std::ios::binary};
+        stream.seekp(offset);
+        stream.put('\x7f');
+    };
+    permutation::MappedTableFile file;
+
+    // the last word, the header is still valid
+    overwriteByte(std::filesystem::file_size(path) - 1);
+    EXPECT_FALSE(file.open(directory.string(), 5, 2, 3));
+
+    // the version right behind the magic
+    ASSERT_TRUE(
+        permutation::writeTableFile(directory.string(), 5, 2, 3, words));
+    overwriteByte(8);
+    EXPECT_FALSE(file.open(directory.string(), 5, 2, 3));
+
+    std::filesystem::remove_all(directory);
+}
+#endif
+
 #endif // TST_PERMUTATION_PERMUTATIONTEST_H
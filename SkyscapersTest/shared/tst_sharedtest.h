@@ -0,0 +1,418 @@
+#ifndef TST_SHARED_SHAREDTEST_H
+#define TST_SHARED_SHAREDTEST_H
+
+#include <gmock/gmock-matchers.h>
+#include <gtest/gtest.h>
+
+#include "../../Skyscrapers/shared/bitmask.h"
+#include "../../Skyscrapers/shared/board.h"
+#include "../../Skyscrapers/shared/cluebounds.h"
+#include "../../Skyscrapers/shared/cluedomains.h"
+#include "../../Skyscrapers/shared/linesolver.h"
+#include "../../Skyscrapers/shared/linesolvercache.h"
+#include "../../Skyscrapers/shared/rowkernels.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+inline int visibleBuildings(const std::vector<int> &values)
+{
+    int visible = 0;
+    int tallest = 0;
+    for (auto value : values) {
+        if (value > tallest) {
+            tallest = value;
+            ++visible;
+        }
+    }
+    return visible;
+}
+
+// union of all permutations which fit to the clues and the domains, false if
+// there is none
+inline bool bruteForceLine(std::size_t size, int front, int back,
+                           const RowMasks &domains, RowMasks &supported)
+{
+    supported = RowMasks{};
+    bool solvable = false;
+    std::vector<int> values(size);
+    std::iota(values.begin(), values.end(), 1);
+    do {
+        bool fits = true;
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            fits = fits &&
+                   (domains[idx] & valueBitmask(values[idx])) != BitmaskType{};
+        }
+        fits = fits && (front == 0 || visibleBuildings(values) == front);
+        std::vector<int> reversed(values.rbegin(), values.rend());
+        fits = fits && (back == 0 || visibleBuildings(reversed) == back);
+        if (!fits) {
+            continue;
+        }
+        solvable = true;
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            supported[idx] |= valueBitmask(values[idx]);
+        }
+    } while (std::next_permutation(values.begin(), values.end()));
+    return solvable;
+}
+
+TEST(LineSolver, fits_to_brute_force)
+{
+    std::mt19937 random{42};
+    LineSolverScratch scratch;
+
+    for (std::size_t size = 1; size <= 6; ++size) {
+        for (int front = 0; front <= static_cast<int>(size); ++front) {
+            for (int back = 0; back <= static_cast<int>(size); ++back) {
+                for (int round = 0; round < 8; ++round) {
+                    // every value is removed from a field with 1 in 4
+                    RowMasks domains{};
+                    for (std::size_t idx = 0; idx < size; ++idx) {
+                        domains[idx] = fullBitmask(size);
+                        for (int value = 1; value <= static_cast<int>(size);
+                             ++value) {
+                            if (round > 0 && random() % 4 == 0) {
+                                domains[idx] &= static_cast<BitmaskType>(
+                                    ~valueBitmask(value));
+                            }
+                        }
+                    }
+                    RowMasks expected;
+                    auto expectedSolvable =
+                        bruteForceLine(size, front, back, domains, expected);
+
+                    RowMasks supported;
+                    EXPECT_EQ(solveLine(size, front, back, domains,
+                                        supported, scratch),
+                              expectedSolvable)
+                        << size << " " << front << " " << back;
+                    EXPECT_EQ(supported, expected)
+                        << size << " " << front << " " << back;
+                }
+            }
+        }
+    }
+}
+
+TEST(ClueBounds, keeps_all_values_of_fitting_permutations)
+{
+    std::mt19937 random{7};
+
+    for (std::size_t size = 1; size <= 7; ++size) {
+        for (int front = 0; front <= static_cast<int>(size); ++front) {
+            for (int back = 0; back <= static_cast<int>(size); ++back) {
+                for (int round = 0; round < 8; ++round) {
+                    RowMasks domains{};
+                    for (std::size_t idx = 0; idx < size; ++idx) {
+                        domains[idx] = fullBitmask(size);
+                        for (int value = 1; value <= static_cast<int>(size);
+                             ++value) {
+                            if (round > 0 && random() % 4 == 0) {
+                                domains[idx] &= static_cast<BitmaskType>(
+                                    ~valueBitmask(value));
+                            }
+                        }
+                    }
+                    RowMasks expected;
+                    bruteForceLine(size, front, back, domains, expected);
+
+                    auto masks = domains;
+                    narrowToClueBounds(masks, size, front, back);
+                    for (std::size_t idx = 0; idx < size; ++idx) {
+                        // values only get removed, never the ones of a
+                        // fitting permutation
+                        EXPECT_EQ(masks[idx] & ~domains[idx], BitmaskType{});
+                        EXPECT_EQ(expected[idx] & ~masks[idx], BitmaskType{})
+                            << size << " " << front << " " << back << " "
+                            << idx;
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(ClueBounds, narrows_from_front_and_back)
+{
+    std::size_t size = 5;
+    RowMasks full{};
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        full[idx] = fullBitmask(size);
+    }
+
+    // only the tallest building is visible in front of clue 1, so it is
+    // not in the last field
+    auto masks = full;
+    narrowToClueBounds(masks, size, 1, 0);
+    EXPECT_EQ(masks[0], valueBitmask(5));
+    EXPECT_EQ(masks[4], fullBitmask(4));
+
+    masks = full;
+    narrowToClueBounds(masks, size, 0, 1);
+    EXPECT_EQ(masks[0], fullBitmask(4));
+    EXPECT_EQ(masks[4], valueBitmask(5));
+
+    // with clue 3 the tallest building has at least two buildings in front
+    // and the first field cannot take the two tallest values
+    masks = full;
+    narrowToClueBounds(masks, size, 3, 0);
+    EXPECT_EQ(masks[0], fullBitmask(3));
+    EXPECT_EQ(masks[1] & valueBitmask(5), BitmaskType{});
+
+    masks = full;
+    narrowToClueBounds(masks, size, 0, 3);
+    EXPECT_EQ(masks[4], fullBitmask(3));
+    EXPECT_EQ(masks[3] & valueBitmask(5), BitmaskType{});
+
+    masks = full;
+    narrowToClueBounds(masks, size, 1, 3);
+    EXPECT_EQ(masks[0], valueBitmask(5));
+    EXPECT_EQ(masks[4], fullBitmask(3));
+}
+
+TEST(ClueDomains, fits_to_brute_force)
+{
+    for (std::size_t size = 1; size <= 7; ++size) {
+        RowMasks full{};
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            full[idx] = fullBitmask(size);
+        }
+        for (int front = 0; front <= static_cast<int>(size); ++front) {
+            for (int back = 0; back <= static_cast<int>(size); ++back) {
+                RowMasks expected;
+                bruteForceLine(size, front, back, full, expected);
+                EXPECT_EQ(clueDomains(size, front, back), expected)
+                    << size << " " << front << " " << back;
+            }
+        }
+    }
+}
+
+TEST(ClueDomains, backClueIdx)
+{
+    // the clues of a 4x4 board go clockwise around it from top left
+    EXPECT_EQ(backClueIdx(0, 4), 11u);
+    EXPECT_EQ(backClueIdx(3, 4), 8u);
+    EXPECT_EQ(backClueIdx(4, 4), 15u);
+    EXPECT_EQ(backClueIdx(7, 4), 12u);
+}
+
+TEST(LineSolverCache, repeated_row_hits_cache)
+{
+    std::size_t size = 5;
+    LineSolverCache cache;
+    LineSolverScratch scratch;
+
+    RowMasks domains{};
+    domains.fill(fullBitmask(size));
+    domains[1] = valueBitmask(5);
+
+    RowMasks first;
+    EXPECT_TRUE(cache.solve(size, 2, 3, domains, first, scratch));
+    EXPECT_EQ(cache.hits(), 0u);
+    EXPECT_EQ(cache.misses(), 1u);
+
+    RowMasks second;
+    EXPECT_TRUE(cache.solve(size, 2, 3, domains, second, scratch));
+    EXPECT_EQ(cache.hits(), 1u);
+    EXPECT_EQ(cache.misses(), 1u);
+    EXPECT_DOUBLE_EQ(cache.hitRate(), 0.5);
+    EXPECT_EQ(second, first);
+
+    RowMasks expected;
+    EXPECT_TRUE(solveLine(size, 2, 3, domains, expected, scratch));
+    EXPECT_EQ(second, expected);
+
+    cache.clear();
+    EXPECT_DOUBLE_EQ(cache.hitRate(), 0.0);
+}
+
+TEST(WideBitmask, operations)
+{
+    using Bitmask = WideBitmask<2>;
+
+    auto low = valueBitmask<Bitmask>(3);
+    auto high = valueBitmask<Bitmask>(70);
+    EXPECT_EQ(low.word(0), 4u);
+    EXPECT_EQ(low.word(1), 0u);
+    EXPECT_EQ(high.word(0), 0u);
+    EXPECT_EQ(high.word(1), 32u);
+
+    auto both = low | high;
+    EXPECT_EQ(popCount(both), 2);
+    EXPECT_EQ(countTrailingZeros(both), 2);
+    EXPECT_EQ(bitWidth(both), 70);
+    EXPECT_FALSE(hasSingleBit(both));
+    EXPECT_TRUE(hasSingleBit(high));
+    EXPECT_EQ(clearLowestBit(both), high);
+    EXPECT_EQ(both & high, high);
+    EXPECT_EQ(both ^ high, low);
+    EXPECT_NE(both, low);
+
+    auto full = fullBitmask<Bitmask>(100);
+    EXPECT_EQ(popCount(full), 100);
+    EXPECT_EQ(bitWidth(full), 100);
+    EXPECT_EQ(popCount(~full), 28);
+    EXPECT_EQ(countTrailingZeros(~full), 100);
+    EXPECT_EQ(fullBitmask<Bitmask>(128), ~Bitmask{});
+    EXPECT_EQ(Bitmask{5}.word(0), 5u);
+    EXPECT_EQ(countTrailingZeros(Bitmask{}), 128);
+}
+
+TEST(RowKernels, fit_to_plain_loops)
+{
+    std::mt19937_64 random{42};
+    auto randomMask = [&](std::size_t size) {
+        switch (random() % 4) {
+        case 0:
+            return valueBitmask(static_cast<int>(random() % size) + 1);
+        case 1:
+            return BitmaskType{};
+        default:
+            return static_cast<BitmaskType>(random());
+        }
+    };
+
+    for (std::size_t size = 1; size <= maxBoardSize; ++size) {
+        for (int round = 0; round < 20; ++round) {
+            RowMasks masks{};
+            RowMasks other{};
+            for (std::size_t lane = 0; lane < rowLanes; ++lane) {
+                masks[lane] = randomMask(size);
+                other[lane] = random() % 2 == 0 ? masks[lane]
+                                                : randomMask(size);
+            }
+
+            BitmaskType singles{};
+            for (std::size_t lane = 0; lane < size; ++lane) {
+                if (hasSingleBit(masks[lane])) {
+                    singles |= laneBitmask(lane);
+                }
+            }
+            EXPECT_EQ(singleBitLanes(masks, size), singles);
+
+            auto intersected = masks;
+            BitmaskType changed{};
+            for (std::size_t lane = 0; lane < size; ++lane) {
+                auto result = static_cast<BitmaskType>(masks[lane] &
+                                                       other[lane]);
+                if (result != masks[lane]) {
+                    changed |= laneBitmask(lane);
+                }
+            }
+            EXPECT_EQ(intersectMasks(intersected, other, size), changed);
+            for (std::size_t lane = 0; lane < size; ++lane) {
+                EXPECT_EQ(intersected[lane],
+                          static_cast<BitmaskType>(masks[lane] & other[lane]));
+            }
+        }
+    }
+}
+
+TEST(Board, rejects_sizes_above_max_board_size)
+{
+    EXPECT_NO_THROW(Board{maxBoardSize});
+    EXPECT_THROW(Board{maxBoardSize + 1}, std::invalid_argument);
+}
+
+// everything a rollback has to restore, the epochs of the rows are left out
+// because they also change on a rollback
+inline auto boardState(const Board &board)
+{
+    auto counterState = [](const RowCounters &counters) {
+        return std::make_tuple(counters.skyscrapers, counters.skyscraperCount,
+                               counters.skyscraperCounts,
+                               counters.candidateCounts,
+                               counters.singleCandidates);
+    };
+    std::vector<decltype(counterState(board.rowCounters(0)))> counters;
+    for (std::size_t idx = 0; idx < board.size(); ++idx) {
+        counters.push_back(counterState(board.rowCounters(idx)));
+        counters.push_back(counterState(board.columnCounters(idx)));
+    }
+    return std::make_tuple(board.fields(), board.transposedFields(),
+                           board.skyscraperCount(), board.hasContradiction(),
+                           counters);
+}
+
+inline Field skyscraperField(int skyscraper)
+{
+    Field field;
+    field.insertSkyscraper(skyscraper);
+    return field;
+}
+
+TEST(Board, rollback_restores_nested_checkpoints)
+{
+    Board board{4};
+    auto initialState = boardState(board);
+    auto outerMark = board.checkpoint();
+
+    ASSERT_TRUE(board.setField(0, skyscraperField(1)));
+    ASSERT_TRUE(board.propagate());
+    auto outerState = boardState(board);
+    auto innerMark = board.checkpoint();
+    EXPECT_GT(innerMark, outerMark);
+
+    // the events of these changes are still queued
+    ASSERT_TRUE(board.setField(5, skyscraperField(2)));
+    ASSERT_TRUE(board.setField(10, skyscraperField(3)));
+    EXPECT_NE(boardState(board), outerState);
+
+    board.rollback(innerMark);
+    EXPECT_EQ(boardState(board), outerState);
+    EXPECT_EQ(board.checkpoint(), innerMark);
+    // no event of the rolled back changes is left to propagate
+    EXPECT_TRUE(board.propagate());
+    EXPECT_EQ(board.checkpoint(), innerMark);
+    EXPECT_EQ(boardState(board), outerState);
+
+    // a contradiction after the mark is gone with the rollback
+    EXPECT_FALSE(board.setField(1, skyscraperField(1)));
+    EXPECT_TRUE(board.hasContradiction());
+    board.rollback(innerMark);
+    EXPECT_FALSE(board.hasContradiction());
+    EXPECT_EQ(boardState(board), outerState);
+
+    board.rollback(outerMark);
+    EXPECT_EQ(boardState(board), initialState);
+}
+
+TEST(Board, inconsistent_input_is_a_contradiction)
+{
+    {
+        // 4 visible from both sides of the first column
+        Board board{4};
+        std::vector<int> clues(16, 0);
+        clues[0] = 4;
+        clues[11] = 4;
+        EXPECT_FALSE(board.insertClues(clues));
+        EXPECT_TRUE(board.hasContradiction());
+    }
+    {
+        Board board{4};
+        std::vector<std::vector<int>> startingGrid{
+            {1, 1, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}, {0, 0, 0, 0}};
+        EXPECT_FALSE(board.insert(startingGrid));
+        EXPECT_TRUE(board.hasContradiction());
+    }
+    {
+        // the last three fields of the first row can only take 1 and 2
+        Board board{4};
+        Field field{static_cast<BitmaskType>(
+            valueBitmask(1) | valueBitmask(2) | ~fullBitmask(4))};
+        ASSERT_TRUE(board.setField(1, field));
+        ASSERT_TRUE(board.setField(2, field));
+        ASSERT_TRUE(board.setField(3, field));
+        EXPECT_FALSE(board.hasContradiction());
+        EXPECT_FALSE(board.propagate());
+        EXPECT_TRUE(board.hasContradiction());
+    }
+}
+
+#endif // TST_SHARED_SHAREDTEST_H
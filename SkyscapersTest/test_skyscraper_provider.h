@@ -25,6 +25,15 @@ TestSkyscraperProvider sky4_hard_2{
     {0, 3, 0, 1, 0, 0, 0, 0, 2, 0, 0, 0, 0, 0, 2, 0},
     {{1, 2, 3, 4}, {3, 1, 4, 2}, {4, 3, 2, 1}, {2, 4, 1, 3}}};
 
+// a row gets all its skyscrapers out of the crossing rows
+TestSkyscraperProvider sky5_sparse{
+    {0, 0, 0, 0, 2, 2, 4, 2, 3, 0, 0, 0, 4, 0, 2, 4, 0, 0, 0, 2},
+    {{3, 2, 5, 1, 4},
+     {2, 5, 4, 3, 1},
+     {4, 1, 3, 5, 2},
+     {5, 4, 1, 2, 3},
+     {1, 3, 2, 4, 5}}};
+
 TestSkyscraperProvider sky6_easy{
     {3, 2, 2, 3, 2, 1, 1, 2, 3, 3, 2, 2, 5, 1, 2, 2, 4, 3, 3, 2, 1, 2, 2, 4},
     {{{2, 1, 4, 3, 5, 6},
@@ -2,7 +2,6 @@
 
 #include "backtracking/algorithm.h"
 #include "shared/board.h"
-#include "shared/rowclues.h"
 
 #include <algorithm>
 #include <cassert>
@@ -18,12 +17,11 @@ SolvePuzzle(const std::vector<int> &clues,
 
     std::size_t boardSize = clues.size() / 4;
 
-    auto rowClues = getRowClues(clues, boardSize);
-
     Board board{boardSize};
 
-    board.insert(rowClues);
-    board.insert(startingGrid);
+    if (!board.insertClues(clues) || !board.insert(startingGrid)) {
+        return board.skyscrapers2d();
+    }
 
     if (board.isSolved()) {
         return board.skyscrapers2d();
@@ -41,7 +39,7 @@ std::vector<std::vector<int>> SolvePuzzle(const std::vector<int> &clues)
 
 void solveBoard(Board &board, const std::vector<int> &clues)
 {
-    guessSkyscrapers(board, clues, 0, board.fields.size(), board.size());
+    guessSkyscrapers(board, clues, 0, board.fields().size(), board.size());
 }
 
 } // namespace backtracking
@@ -22,9 +22,8 @@ bool guessSkyscrapers(Board &board, const std::vector<int> &clues,
         return true;
     }
 
-    if (board.fields[index].hasSkyscraper()) {
-        if (!skyscrapersAreValidPositioned(board.fields, clues, index,
-                                           rowSize)) {
+    if (board.fields()[index].hasSkyscraper()) {
+        if (!skyscrapersAreValidPositioned(board, clues, index, rowSize)) {
             return false;
         }
         if (guessSkyscrapers(board, clues, index + 1, countOfElements,
@@ -34,81 +33,64 @@ bool guessSkyscrapers(Board &board, const std::vector<int> &clues,
         return false;
     }
 
-    auto oldField = board.fields[index];
+    auto oldField = board.fields()[index];
+    auto mark = board.checkpoint();
     for (int trySkyscraper = 1; trySkyscraper <= static_cast<int>(rowSize);
          ++trySkyscraper) {
 
-        if (board.fields[index].containsNope(trySkyscraper)) {
+        if (oldField.containsNope(trySkyscraper)) {
             continue;
         }
-        board.fields[index].insertSkyscraper(trySkyscraper);
-        if (!skyscrapersAreValidPositioned(board.fields, clues, index,
-                                           rowSize)) {
-            board.fields[index] = oldField;
+        if (!rowsAreValid(board, index, trySkyscraper, rowSize) ||
+            !columnsAreValid(board, index, trySkyscraper, rowSize)) {
+            continue;
+        }
+        Field field;
+        field.insertSkyscraper(trySkyscraper);
+        // propagating the guess finds most dead ends before the clues of
+        // the row and column can be checked
+        if (!board.setField(index, field) || !board.propagate() ||
+            !skyscrapersAreValidPositioned(board, clues, index, rowSize)) {
+            board.rollback(mark);
             continue;
         }
         if (guessSkyscrapers(board, clues, index + 1, countOfElements,
                              rowSize)) {
             return true;
         }
-        board.fields[index] = oldField;
+        board.rollback(mark);
     }
-    board.fields[index] = oldField;
     return false;
 }
 
-bool skyscrapersAreValidPositioned(const std::vector<Field> &fields,
+bool skyscrapersAreValidPositioned(const Board &board,
                                    const std::vector<int> &clues,
                                    std::size_t index, std::size_t rowSize)
 {
-    if (!rowsAreValid(fields, index, rowSize)) {
-        return false;
-    }
-    if (!columnsAreValid(fields, index, rowSize)) {
+    if (!cluesInRowAreValid(board.fields(), clues, index, rowSize)) {
         return false;
     }
-    if (!cluesInRowAreValid(fields, clues, index, rowSize)) {
-        return false;
-    }
-    if (!cluesInColumnAreValid(fields, clues, index, rowSize)) {
+    if (!cluesInColumnAreValid(board.transposedFields(), clues, index,
+                               rowSize)) {
         return false;
     }
     return true;
 }
 
-bool rowsAreValid(const std::vector<Field> &fields, std::size_t index,
+bool rowsAreValid(const Board &board, std::size_t index, int skyscraper,
                   std::size_t rowSize)
 {
     std::size_t row = index / rowSize;
-    for (std::size_t currIndex = row * rowSize; currIndex < (row + 1) * rowSize;
-         ++currIndex) {
-        if (currIndex == index) {
-            continue;
-        }
-        if (fields[currIndex].skyscraper(rowSize) ==
-            fields[index].skyscraper(rowSize)) {
-            return false;
-        }
-    }
-    return true;
+    return (board.rowSkyscrapers(row) & valueBitmask(skyscraper)) ==
+           BitmaskType{};
 }
 
-bool columnsAreValid(const std::vector<Field> &fields, std::size_t index,
+bool columnsAreValid(const Board &board, std::size_t index, int skyscraper,
                      std::size_t rowSize)
 {
     std::size_t column = index % rowSize;
-
-    for (std::size_t i = 0; i < rowSize; ++i) {
-        std::size_t currIndex = column + i * rowSize;
-        if (currIndex == index) {
-            continue;
-        }
-        if (fields[currIndex].skyscraper(rowSize) ==
-            fields[index].skyscraper(rowSize)) {
-            return false;
-        }
-    }
-    return true;
+    return (board.columnSkyscrapers(column) & valueBitmask(skyscraper)) ==
+           BitmaskType{};
 }
 
 bool cluesInRowAreValid(const std::vector<Field> &fields,
@@ -138,7 +120,7 @@ bool cluesInRowAreValid(const std::vector<Field> &fields,
     }
 
     if (frontClue != 0) {
-        auto frontVisible = visibleBuildings(citBegin, citEnd, rowSize);
+        auto frontVisible = visibleBuildings(citBegin, citEnd);
 
         if (frontClue != frontVisible) {
             return false;
@@ -149,7 +131,7 @@ bool cluesInRowAreValid(const std::vector<Field> &fields,
     auto critEnd = std::make_reverse_iterator(citBegin);
 
     if (backClue != 0) {
-        auto backVisible = visibleBuildings(critBegin, critEnd, rowSize);
+        auto backVisible = visibleBuildings(critBegin, critEnd);
 
         if (backClue != backVisible) {
             return false;
@@ -166,7 +148,7 @@ std::tuple<int, int> getCluesInRow(const std::vector<int> &clues,
     return {frontClue, backClue};
 }
 
-bool cluesInColumnAreValid(const std::vector<Field> &fields,
+bool cluesInColumnAreValid(const std::vector<Field> &transposedFields,
                            const std::vector<int> &clues, std::size_t index,
                            std::size_t rowSize)
 {
@@ -178,33 +160,34 @@ bool cluesInColumnAreValid(const std::vector<Field> &fields,
         return true;
     }
 
-    std::vector<Field> verticalFields;
-    verticalFields.reserve(rowSize);
+    std::size_t columnIndexBegin = column * rowSize;
+    std::size_t columnIndexEnd = (column + 1) * rowSize;
 
-    for (std::size_t i = 0; i < rowSize; ++i) {
-        verticalFields.emplace_back(fields[column + i * rowSize]);
-    }
+    auto citBegin = transposedFields.cbegin() + columnIndexBegin;
+    auto citEnd = transposedFields.cbegin() + columnIndexEnd;
 
     bool columnIsFull =
-        std::find_if(verticalFields.cbegin(), verticalFields.cend(),
-                     [](const Field &field) {
-                         return !field.hasSkyscraper();
-                     }) == verticalFields.cend();
+        std::find_if(citBegin, citEnd, [](const Field &field) {
+            return !field.hasSkyscraper();
+        }) == citEnd;
 
     if (!columnIsFull) {
         return true;
     }
 
     if (frontClue != 0) {
-        auto frontVisible = visibleBuildings(verticalFields.cbegin(),
-                                             verticalFields.cend(), rowSize);
+        auto frontVisible = visibleBuildings(citBegin, citEnd);
+
         if (frontClue != frontVisible) {
             return false;
         }
     }
+
+    auto critBegin = std::make_reverse_iterator(citEnd);
+    auto critEnd = std::make_reverse_iterator(citBegin);
+
     if (backClue != 0) {
-        auto backVisible = visibleBuildings(verticalFields.crbegin(),
-                                            verticalFields.crend(), rowSize);
+        auto backVisible = visibleBuildings(critBegin, critEnd);
 
         if (backClue != backVisible) {
             return false;
@@ -1,6 +1,7 @@
 #ifndef BACKTRACKING_ALGORITHM_H
 #define BACKTRACKING_ALGORITHM_H
 
+#include <tuple>
 #include <vector>
 
 class Board;
@@ -12,14 +13,15 @@ bool guessSkyscrapers(Board &board, const std::vector<int> &clues,
                       std::size_t index, std::size_t countOfElements,
                       std::size_t rowSize);
 
-bool skyscrapersAreValidPositioned(const std::vector<Field> &fields,
+bool skyscrapersAreValidPositioned(const Board &board,
                                    const std::vector<int> &clues,
                                    std::size_t index, std::size_t rowSize);
 
-bool rowsAreValid(const std::vector<Field> &fields, std::size_t index,
+// skyscraper is not placed in the row / column of index yet
+bool rowsAreValid(const Board &board, std::size_t index, int skyscraper,
                   std::size_t rowSize);
 
-bool columnsAreValid(const std::vector<Field> &fields, std::size_t index,
+bool columnsAreValid(const Board &board, std::size_t index, int skyscraper,
                      std::size_t rowSize);
 
 bool cluesInRowAreValid(const std::vector<Field> &fields,
@@ -29,7 +31,7 @@ bool cluesInRowAreValid(const std::vector<Field> &fields,
 std::tuple<int, int> getCluesInRow(const std::vector<int> &clues,
                                    std::size_t row, std::size_t rowSize);
 
-bool cluesInColumnAreValid(const std::vector<Field> &fields,
+bool cluesInColumnAreValid(const std::vector<Field> &transposedFields,
                            const std::vector<int> &clues, std::size_t index,
                            std::size_t rowSize);
 
@@ -37,16 +39,14 @@ std::tuple<int, int> getCluesInColumn(const std::vector<int> &clues,
                                       std::size_t column, std::size_t rowSize);
 
 template <typename FieldIterator>
-int visibleBuildings(FieldIterator begin, FieldIterator end,
-                     std::size_t rowSize)
+int visibleBuildings(FieldIterator begin, FieldIterator end)
 {
     int visibleBuildingsCount = 0;
     int highestSeen = 0;
     for (auto it = begin; it != end; ++it) {
-        if (it->skyscraper(rowSize) != 0 &&
-            it->skyscraper(rowSize) > highestSeen) {
+        if (it->skyscraper() != 0 && it->skyscraper() > highestSeen) {
             ++visibleBuildingsCount;
-            highestSeen = it->skyscraper(rowSize);
+            highestSeen = it->skyscraper();
         }
     }
     return visibleBuildingsCount;
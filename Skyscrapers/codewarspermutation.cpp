@@ -5,8 +5,10 @@
 #include <iomanip>
 #include <iostream>
 #include <numeric>
+#include <optional>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
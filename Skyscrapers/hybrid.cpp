@@ -4,7 +4,6 @@
 #include "permutation.h"
 
 #include "shared/board.h"
-#include "shared/rowclues.h"
 
 #include <algorithm>
 #include <cassert>
@@ -41,32 +40,30 @@ double startingGridFactor(const std::vector<std::vector<int>> &startingGrid)
 double skyscraperFactor(const Board &board)
 {
     int skyscraperCount = 0;
-    for (const auto &field : board.fields) {
+    for (const auto &field : board.fields()) {
         if (field.hasSkyscraper()) {
             ++skyscraperCount;
         }
     }
-    return static_cast<double>(skyscraperCount) / board.fields.size();
+    return static_cast<double>(skyscraperCount) / board.fields().size();
 }
 
 double nopeFactor(const Board &board)
 {
     double nopeCount = 0;
     auto boardSize = board.size();
-    for (const auto &field : board.fields) {
-        if (!field.nopes(board.size()).empty()) {
-            auto nopes = field.nopes(board.size());
-            nopeCount += static_cast<double>(nopes.size()) / boardSize;
-        }
+    for (const auto &field : board.fields()) {
+        auto nopes = field.nopes(board.size());
+        nopeCount += static_cast<double>(nopes.size()) / boardSize;
     }
-    return static_cast<double>(nopeCount) / board.fields.size();
+    return static_cast<double>(nopeCount) / board.fields().size();
 }
 
 double fieldFactor(const Board &board)
 {
     double fieldCount = 0;
     auto boardSize = board.size();
-    for (const auto &field : board.fields) {
+    for (const auto &field : board.fields()) {
         if (field.hasSkyscraper()) {
             ++fieldCount;
         }
@@ -75,7 +72,7 @@ double fieldFactor(const Board &board)
             fieldCount += static_cast<double>(nopes.size()) / boardSize;
         }
     }
-    return fieldCount / board.fields.size();
+    return fieldCount / board.fields().size();
 }
 
 std::vector<std::vector<int>>
@@ -86,12 +83,11 @@ SolvePuzzle(const std::vector<int> &clues,
 
     std::size_t boardSize = clues.size() / 4;
 
-    auto rowClues = getRowClues(clues, boardSize);
-
     Board board{boardSize};
 
-    board.insert(rowClues);
-    board.insert(startingGrid);
+    if (!board.insertClues(clues) || !board.insert(startingGrid)) {
+        return board.skyscrapers2d();
+    }
 
     if (board.isSolved()) {
         return board.skyscrapers2d();
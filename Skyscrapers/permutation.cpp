@@ -5,13 +5,113 @@
 #include "permutation/slice.h"
 #include "shared/board.h"
 #include "shared/row.h"
-#include "shared/rowclues.h"
 
 #include <cassert>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
 
 namespace permutation {
 
+namespace {
+
+// false on a contradiction. Stops once no slice can narrow its fields
+// anymore which does not mean the board is solved
+bool propagateSlices(Board &board, std::vector<Slice> &slices)
+{
+    // only slices with changed fields are visited. The ones with the
+    // fewest permutations first, they are cheap and narrow the fields most.
+    // A row which got all its skyscrapers out of the crossing rows is still
+    // visited to check it against its permutations
+    using DirtySlice = std::pair<std::uint64_t, std::size_t>;
+    for (;;) {
+        std::priority_queue<DirtySlice, std::vector<DirtySlice>,
+                            std::greater<DirtySlice>>
+            dirtySlices;
+        for (std::size_t i = 0; i < slices.size(); ++i) {
+            if (slices[i].isDirty()) {
+                dirtySlices.emplace(slices[i].permutationCount(), i);
+            }
+        }
+        if (dirtySlices.empty()) {
+            return true;
+        }
+
+        while (!dirtySlices.empty()) {
+            auto &slice = slices[dirtySlices.top().second];
+            dirtySlices.pop();
+
+            // already visited because of a change in another row
+            if (!slice.isDirty()) {
+                continue;
+            }
+            if (!slice.solveFromPossiblePermutations(board.size()) ||
+                !slice.guessSkyscraperOutOfNeighbourNopes()) {
+                return false;
+            }
+        }
+    }
+}
+
+// the unsolved slice with the fewest permutations, rows with clues first
+Slice &branchSlice(std::vector<Slice> &slices)
+{
+    Slice *best = nullptr;
+    for (auto &slice : slices) {
+        if (slice.isSolved()) {
+            continue;
+        }
+        if (!best ||
+            (slice.hasPermutations() && !best->hasPermutations()) ||
+            (slice.hasPermutations() == best->hasPermutations() &&
+             slice.permutationCount() < best->permutationCount())) {
+            best = &slice;
+        }
+    }
+    assert(best);
+    return *best;
+}
+
+// Propagates and if that stalls guesses the values of a field out of the
+// slice with the fewest permutations. A failed guess is taken back with the
+// trail of the board and the saved states of the slices
+bool searchSlices(Board &board, std::vector<Slice> &slices)
+{
+    if (!propagateSlices(board, slices)) {
+        return false;
+    }
+    if (board.isSolved()) {
+        return true;
+    }
+
+    auto &slice = branchSlice(slices);
+    auto idx = slice.branchField(board.size());
+    auto values = slice.fieldValues(idx, board.size());
+
+    auto mark = board.checkpoint();
+    std::vector<Slice::State> states;
+    states.reserve(slices.size());
+    for (const auto &s : slices) {
+        states.emplace_back(s.state());
+    }
+
+    for (; values != BitmaskType{}; values = clearLowestBit(values)) {
+        if (slice.guessSkyscraper(idx, countTrailingZeros(values) + 1) &&
+            searchSlices(board, slices)) {
+            return true;
+        }
+        board.rollback(mark);
+        for (std::size_t i = 0; i < slices.size(); ++i) {
+            slices[i].restore(states[i]);
+        }
+    }
+    return false;
+}
+
+} // namespace
+
 std::vector<std::vector<int>>
 SolvePuzzle(const std::vector<int> &clues,
             std::vector<std::vector<int>> startingGrid, int)
@@ -20,12 +120,11 @@ SolvePuzzle(const std::vector<int> &clues,
 
     std::size_t boardSize = clues.size() / 4;
 
-    auto rowClues = getRowClues(clues, boardSize);
-
     Board board{boardSize};
 
-    board.insert(rowClues);
-    board.insert(startingGrid);
+    if (!board.insertClues(clues) || !board.insert(startingGrid)) {
+        return board.skyscrapers2d();
+    }
 
     if (board.isSolved()) {
         return board.skyscrapers2d();
@@ -41,34 +140,25 @@ std::vector<std::vector<int>> SolvePuzzle(const std::vector<int> &clues)
     return SolvePuzzle(clues, std::vector<std::vector<int>>{}, 0);
 }
 
-void solveBoard(Board &board, const std::vector<int> &clues)
+bool solveBoard(Board &board, const std::vector<int> &clues)
 {
     auto cluePairs = makeCluePairs(clues);
     Permutations permutations(board.size(),
                               Span{&cluePairs[0], cluePairs.size()},
                               Span{&board.mRows[0], board.mRows.size()});
 
+    if (!permutations.fitsAllCluePairs()) {
+        return false;
+    }
+
     std::vector<Slice> slices =
         makeSlices(permutations, board.mRows, cluePairs, board.size());
 
-    for (;;) {
-        bool allFull = true;
-        for (std::size_t i = 0; i < slices.size(); ++i) {
-            if (slices[i].isSolved()) {
-                continue;
-            }
-            slices[i].solveFromPossiblePermutations(board.size());
-            slices[i].guessSkyscraperOutOfNeighbourNopes();
-
-            if (!slices[i].isSolved()) {
-                allFull = false;
-            }
-        }
-
-        if (allFull) {
-            break;
-        }
+    if (board.hasContradiction()) {
+        return false;
     }
+
+    return searchSlices(board, slices);
 }
 
 } // namespace permutation
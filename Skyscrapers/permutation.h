@@ -13,7 +13,8 @@ std::vector<std::vector<int>>
 SolvePuzzle(const std::vector<int> &clues,
             std::vector<std::vector<int>> startingGrid, int N);
 
-void solveBoard(Board &board, const std::vector<int> &clues);
+// false if the board has no solution
+bool solveBoard(Board &board, const std::vector<int> &clues);
 
 } // namespace permutation
 
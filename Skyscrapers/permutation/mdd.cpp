@@ -0,0 +1,228 @@
+#include "mdd.h"
+
+#include "../shared/layeredstates.h"
+#include "saturating.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace permutation {
+
+namespace {
+
+// value and node in the next layer
+using Edges = std::vector<std::pair<std::uint8_t, std::uint32_t>>;
+
+constexpr auto deadNode = std::numeric_limits<std::uint32_t>::max();
+
+} // namespace
+
+Mdd::Mdd(std::size_t size, int front, int back) : mSize{size}
+{
+    assert(size > 0 && size <= maxSize);
+    build(front, back);
+}
+
+std::size_t Mdd::size() const
+{
+    return mSize;
+}
+
+std::size_t Mdd::nodeCount() const
+{
+    return mLayerBegin.back();
+}
+
+std::size_t Mdd::edgeCount() const
+{
+    return mEdgeTarget.size();
+}
+
+std::uint64_t Mdd::permutationCount() const
+{
+    return mPermutationCount;
+}
+
+std::uint64_t Mdd::supportedValues(const RowMasks &domains,
+                                   RowMasks &supported,
+                                   MddScratch &scratch) const
+{
+    supported = RowMasks{};
+    if (nodeCount() == 0) {
+        return 0;
+    }
+    auto &paths = scratch.pathsFromRoot;
+    auto &reaches = scratch.reachesTerminal;
+    paths.assign(nodeCount(), 0);
+    reaches.assign(nodeCount(), 0);
+    paths[0] = 1;
+
+    for (std::size_t idx = 0; idx < mSize; ++idx) {
+        for (auto node = mLayerBegin[idx]; node < mLayerBegin[idx + 1];
+             ++node) {
+            if (paths[node] == 0) {
+                continue;
+            }
+            for (auto edge = mEdgeBegin[node]; edge < mEdgeBegin[node + 1];
+                 ++edge) {
+                if ((domains[idx] & valueBitmask(mEdgeValue[edge])) !=
+                    BitmaskType{}) {
+                    auto &target = paths[mEdgeTarget[edge]];
+                    target = saturatingAdd(target, paths[node]);
+                }
+            }
+        }
+    }
+
+    auto terminal = mLayerBegin[mSize];
+    if (paths[terminal] == 0) {
+        return 0;
+    }
+    reaches[terminal] = 1;
+
+    for (auto idx = mSize; idx-- > 0;) {
+        for (auto node = mLayerBegin[idx]; node < mLayerBegin[idx + 1];
+             ++node) {
+            if (paths[node] == 0) {
+                continue;
+            }
+            for (auto edge = mEdgeBegin[node]; edge < mEdgeBegin[node + 1];
+                 ++edge) {
+                auto value = valueBitmask(mEdgeValue[edge]);
+                if ((domains[idx] & value) != BitmaskType{} &&
+                    reaches[mEdgeTarget[edge]] != 0) {
+                    reaches[node] = 1;
+                    supported[idx] |= value;
+                }
+            }
+        }
+    }
+    return paths[terminal];
+}
+
+void Mdd::build(int front, int back)
+{
+    // top down all states which can be reached from the root
+    RowMasks domains{};
+    std::fill(domains.begin(), domains.begin() + mSize, fullBitmask(mSize));
+    LayeredStates layers;
+    if (!buildLayeredStates(mSize, front, back, domains, layers)) {
+        mLayerBegin.assign(mSize + 2, 0);
+        mEdgeBegin.push_back(0);
+        return;
+    }
+    const auto &layerBegin = layers.layerBegin;
+    auto layerSize = [&](std::size_t idx) {
+        return layerBegin[idx + 1] - layerBegin[idx];
+    };
+    // the clues are met exactly at the end so there is only one terminal
+    assert(layerSize(mSize) <= 1);
+
+    // bottom up drop the nodes without a path to the terminal and merge
+    // nodes with the same edges
+    std::vector<std::vector<Edges>> merged(mSize + 1);
+    merged[mSize].resize(layerSize(mSize));
+    std::vector<std::uint32_t> nextMerged(layerSize(mSize), 0);
+
+    for (auto idx = mSize; idx-- > 0;) {
+        std::map<Edges, std::uint32_t> uniqueNodes;
+        std::vector<std::uint32_t> currMerged(layerSize(idx), deadNode);
+        auto edge = layers.edgeBegin[idx];
+
+        for (auto node = layerBegin[idx]; node < layerBegin[idx + 1];
+             ++node) {
+            Edges nodeEdges;
+            for (; edge < layers.edgeBegin[idx + 1] &&
+                   layers.edges[edge].from == node;
+                 ++edge) {
+                auto target =
+                    nextMerged[layers.edges[edge].to - layerBegin[idx + 1]];
+                if (target != deadNode) {
+                    nodeEdges.emplace_back(
+                        static_cast<std::uint8_t>(layers.edges[edge].value),
+                        target);
+                }
+            }
+            if (nodeEdges.empty()) {
+                continue;
+            }
+            auto inserted = uniqueNodes.emplace(
+                nodeEdges, static_cast<std::uint32_t>(merged[idx].size()));
+            if (inserted.second) {
+                merged[idx].push_back(std::move(nodeEdges));
+            }
+            currMerged[node - layerBegin[idx]] = inserted.first->second;
+        }
+        nextMerged = std::move(currMerged);
+    }
+
+    mLayerBegin.assign(mSize + 2, 0);
+    for (std::size_t idx = 0; idx <= mSize; ++idx) {
+        mLayerBegin[idx + 1] =
+            mLayerBegin[idx] + static_cast<std::uint32_t>(merged[idx].size());
+    }
+
+    mEdgeBegin.push_back(0);
+    for (std::size_t idx = 0; idx <= mSize; ++idx) {
+        for (const auto &nodeEdges : merged[idx]) {
+            for (const auto &edge : nodeEdges) {
+                mEdgeValue.push_back(edge.first);
+                mEdgeTarget.push_back(mLayerBegin[idx + 1] + edge.second);
+            }
+            mEdgeBegin.push_back(
+                static_cast<std::uint32_t>(mEdgeTarget.size()));
+        }
+    }
+
+    if (nodeCount() == 0) {
+        return;
+    }
+    // edges only point to nodes with a higher index
+    std::vector<std::uint64_t> counts(nodeCount(), 0);
+    counts[mLayerBegin[mSize]] = 1;
+    for (auto node = mLayerBegin[mSize]; node-- > 0;) {
+        for (auto edge = mEdgeBegin[node]; edge < mEdgeBegin[node + 1];
+             ++edge) {
+            counts[node] =
+                saturatingAdd(counts[node], counts[mEdgeTarget[edge]]);
+        }
+    }
+    mPermutationCount = counts[0];
+}
+
+MddView::MddView(const Mdd *mdd, bool reversed)
+    : mMdd{mdd}, mReversed{reversed}
+{
+}
+
+MddView::operator bool() const
+{
+    return mMdd != nullptr;
+}
+
+std::uint64_t MddView::permutationCount() const
+{
+    assert(mMdd);
+    return mMdd->permutationCount();
+}
+
+std::uint64_t MddView::supportedValues(const RowMasks &domains,
+                                       RowMasks &supported,
+                                       MddScratch &scratch) const
+{
+    assert(mMdd);
+    if (!mReversed) {
+        return mMdd->supportedValues(domains, supported, scratch);
+    }
+    auto size = mMdd->size();
+    auto reversedDomains = domains;
+    std::reverse(reversedDomains.begin(), reversedDomains.begin() + size);
+    auto count = mMdd->supportedValues(reversedDomains, supported, scratch);
+    std::reverse(supported.begin(), supported.begin() + size);
+    return count;
+}
+
+} // namespace permutation
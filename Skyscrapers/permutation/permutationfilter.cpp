@@ -0,0 +1,137 @@
+#include "permutationfilter.h"
+
+#if SKYSCRAPERS_MAX_BOARD_SIZE <= 16 && defined(__AVX2__)
+#define SKYSCRAPERS_PERMUTATIONFILTER_AVX2
+#include <immintrin.h>
+#endif
+
+namespace permutation {
+
+namespace {
+
+// allowed values of the field which is stored in nibble or word idx
+RowMasks storageOrder(const PermutationList &permutationList,
+                      const RowMasks &allowed)
+{
+    auto size = permutationList.size();
+    auto full = fullBitmask(size);
+
+    RowMasks masks{};
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto field = permutationList.isReversed() ? size - 1 - idx : idx;
+        masks[idx] = static_cast<BitmaskType>(allowed[field] & full);
+    }
+    return masks;
+}
+
+bool fits(PermutationWord permutation, const RowMasks &masks,
+          std::size_t size)
+{
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto value = static_cast<int>(permutation & 0xf);
+        if ((masks[idx] & valueBitmask(value + 1)) == BitmaskType{}) {
+            return false;
+        }
+        permutation >>= 4;
+    }
+    return true;
+}
+
+#if defined(SKYSCRAPERS_PERMUTATIONFILTER_AVX2)
+
+// 4 permutations per register, bit 0 of every lane tells if it fits
+__m256i fits(__m256i permutations, const __m256i *masks, std::size_t size)
+{
+    const auto nibble = _mm256_set1_epi64x(0xf);
+    auto result = _mm256_set1_epi64x(1);
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto values = _mm256_and_si256(permutations, nibble);
+        result =
+            _mm256_and_si256(result, _mm256_srlv_epi64(masks[idx], values));
+        permutations = _mm256_srli_epi64(permutations, 4);
+    }
+    return result;
+}
+
+std::uint64_t laneBits(__m256i lanes)
+{
+    return static_cast<std::uint64_t>(
+        _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_slli_epi64(lanes, 63))));
+}
+
+#endif
+
+void filterPacked(const PermutationList &permutationList,
+                  const RowMasks &allowed,
+                  std::vector<std::uint64_t> &survivors)
+{
+    auto size = permutationList.size();
+    auto count = permutationList.count();
+    auto words = permutationList.words();
+    auto masks = storageOrder(permutationList, allowed);
+
+    std::size_t idx = 0;
+#if defined(SKYSCRAPERS_PERMUTATIONFILTER_AVX2)
+    __m256i broadcastMasks[16];
+    for (std::size_t i = 0; i < size; ++i) {
+        broadcastMasks[i] = _mm256_set1_epi64x(masks[i]);
+    }
+    for (; idx + 16 <= count; idx += 16) {
+        auto data = reinterpret_cast<const __m256i *>(words + idx);
+        auto bits =
+            laneBits(fits(_mm256_loadu_si256(data), broadcastMasks, size)) |
+            laneBits(fits(_mm256_loadu_si256(data + 1), broadcastMasks,
+                          size))
+                << 4 |
+            laneBits(fits(_mm256_loadu_si256(data + 2), broadcastMasks,
+                          size))
+                << 8 |
+            laneBits(fits(_mm256_loadu_si256(data + 3), broadcastMasks,
+                          size))
+                << 12;
+        // idx is a multiple of 16 so the 16 bits fit into one word
+        survivors[idx / 64] |= bits << (idx % 64);
+    }
+#endif
+    for (; idx < count; ++idx) {
+        if (fits(words[idx], masks, size)) {
+            survivors[idx / 64] |= std::uint64_t{1} << (idx % 64);
+        }
+    }
+}
+
+void filterUnpacked(const PermutationList &permutationList,
+                    const RowMasks &allowed,
+                    std::vector<std::uint64_t> &survivors)
+{
+    auto size = permutationList.size();
+    for (std::size_t idx = 0; idx < permutationList.count(); ++idx) {
+        bool fitsAll = true;
+        for (std::size_t field = 0; field < size && fitsAll; ++field) {
+            auto value = permutationList.value(
+                static_cast<PermutationIndex>(idx), field);
+            fitsAll = (allowed[field] & valueBitmask(value)) != BitmaskType{};
+        }
+        if (fitsAll) {
+            survivors[idx / 64] |= std::uint64_t{1} << (idx % 64);
+        }
+    }
+}
+
+} // namespace
+
+void filterPermutations(const PermutationList &permutationList,
+                        const RowMasks &allowed,
+                        std::vector<std::uint64_t> &survivors)
+{
+    survivors.assign((permutationList.count() + 63) / 64, 0);
+
+    if constexpr (packedPermutations) {
+        filterPacked(permutationList, allowed, survivors);
+    }
+    else {
+        filterUnpacked(permutationList, allowed, survivors);
+    }
+}
+
+} // namespace permutation
@@ -0,0 +1,25 @@
+#ifndef PERMUTATION_PERMUTATIONFILTER_H
+#define PERMUTATION_PERMUTATIONFILTER_H
+
+#include "../shared/rowkernels.h"
+#include "permutationtable.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace permutation {
+
+/*
+    Sets bit i of survivors if permutation i of permutationList only has
+    values which are toggled in allowed of their field.
+
+    Packed permutations are checked 16 at once if the compiler targets
+    AVX2, otherwise one after another.
+*/
+void filterPermutations(const PermutationList &permutationList,
+                        const RowMasks &allowed,
+                        std::vector<std::uint64_t> &survivors);
+
+} // namespace permutation
+
+#endif
@@ -1,103 +1,81 @@
 #include "permutations.h"
 
 #include "../shared/field.h"
+#include "mdd.h"
+#include "permutationfilter.h"
 
-#include <algorithm>
-#include <numeric>
+#include <cassert>
 
 namespace permutation {
 
 Permutations::Permutations(std::size_t size, Span<CluePair> cluePairs,
                            Span<Row> rows)
-    : mCluePairs(cluePairs), mRows{rows}, mSize{size},
+    : mCluePairs(cluePairs), mSize{size}, mMdds(cluePairs.size()),
       mCluePairsPermutationIndexes(cluePairs.size())
 {
     assert(cluePairs.size() == rows.size());
-    std::vector<int> sequence(mSize);
-    std::iota(sequence.begin(), sequence.end(), 1);
-    mPermutationCount = factorial(sequence.size());
 
-    mPermutations.reserve(mPermutationCount * mSize);
-    int *p = &mPermutations[0];
+    const auto &table = PermutationTable::forSize(mSize);
 
-    for (auto &cluePairPermutationIndexes : mCluePairsPermutationIndexes) {
-        cluePairPermutationIndexes.reserve(mPermutationCount);
-    }
+    std::vector<std::uint64_t> survivors;
+    MddScratch scratch;
 
-    std::size_t currIndex = 0;
-    do {
-        addSequenceToCluePairs(sequence, currIndex);
-        std::copy(sequence.begin(), sequence.end(), p);
-        p += mSize;
-        ++currIndex;
-    } while (std::next_permutation(sequence.begin(), sequence.end()));
-};
+    mPermutationLists.resize(mCluePairs.size());
+    for (std::size_t i = 0; i < mCluePairs.size(); ++i) {
+        if (mCluePairs[i].isEmpty()) {
+            continue;
+        }
+        // the Mdd is only built if it is used
+        if (table.permutationCount(mCluePairs[i]) > maxListPermutations) {
+            if (auto mdd = table.mdd(mCluePairs[i])) {
+                mMdds[i] = mdd;
+                RowMasks supported;
+                if (mdd.supportedValues(rows[i].fieldMasks(), supported,
+                                        scratch) == 0) {
+                    mFitsAllCluePairs = false;
+                }
+                continue;
+            }
+        }
 
-Span<int> Permutations::operator[](std::size_t elem) const
-{
-    auto ptr = &mPermutations[elem * mSize];
-    return Span{ptr, mSize};
-}
+        mPermutationLists[i] = table.permutations(mCluePairs[i]);
 
-std::vector<std::size_t>
-Permutations::permutationIndexs(std::size_t cluePairIndex) const
-{
-    return mCluePairsPermutationIndexes[cluePairIndex];
-}
+        filterPermutations(mPermutationLists[i], rows[i].fieldMasks(),
+                           survivors);
 
-void Permutations::addSequenceToCluePairs(const std::vector<int> &sequence,
-                                          int currIndex)
-{
-    auto front = buildingsVisible(sequence.cbegin(), sequence.cend());
-    auto back = buildingsVisible(sequence.crbegin(), sequence.crend());
-
-    for (std::size_t i = 0; i < mCluePairs.size(); ++i) {
-        if (!permutationFitsCluePair(mCluePairs[i], front, back)) {
-            continue;
+        for (std::size_t word = 0; word < survivors.size(); ++word) {
+            for (auto bits = survivors[word]; bits != 0; bits &= bits - 1) {
+                mCluePairsPermutationIndexes[i].emplace_back(
+                    static_cast<PermutationIndex>(word * 64 +
+                                                  countTrailingZeros(bits)));
+            }
         }
-        if (!existingSkyscrapersInPermutation(i, sequence)) {
-            continue;
+        if (mCluePairsPermutationIndexes[i].empty()) {
+            mFitsAllCluePairs = false;
         }
-        mCluePairsPermutationIndexes[i].emplace_back(currIndex);
     }
 }
 
-bool Permutations::permutationFitsCluePair(const CluePair &cluePair, int front,
-                                           int back)
+PermutationList
+Permutations::permutationList(std::size_t cluePairIndex) const
 {
-    if (cluePair.isEmpty()) {
-        return false;
-    }
-    if (!cluePair.frontIsEmpty() && cluePair.front() != front) {
-        return false;
-    }
-    if (!cluePair.backIsEmpty() && cluePair.back() != back) {
-        return false;
-    }
-    return true;
+    return mPermutationLists[cluePairIndex];
 }
 
-int factorial(int n)
+std::vector<PermutationIndex>
+Permutations::permutationIndexs(std::size_t cluePairIndex) const
 {
-    if (n == 0) {
-        return 1;
-    }
-    return n * factorial(n - 1);
+    return mCluePairsPermutationIndexes[cluePairIndex];
 }
 
-bool Permutations::existingSkyscrapersInPermutation(
-    std::size_t rowIdx, const std::vector<int> &permutation)
+MddView Permutations::mdd(std::size_t cluePairIndex) const
 {
-    for (std::size_t idx = 0; idx < permutation.size(); ++idx) {
-        if (!mRows[rowIdx].getFieldRef(idx).hasSkyscraper()) {
-            continue;
-        }
-        if (mRows[rowIdx].getFieldRef(idx).skyscraper(mSize) !=
-            permutation[idx]) {
-            return false;
-        }
-    }
-    return true;
+    return mMdds[cluePairIndex];
+}
+
+bool Permutations::fitsAllCluePairs() const
+{
+    return mFitsAllCluePairs;
 }
 
 } // namespace permutation
@@ -3,58 +3,50 @@
 
 #include "../shared/row.h"
 #include "cluepair.h"
+#include "mdd.h"
+#include "permutationtable.h"
 #include "span.h"
 
+#include <cstdint>
 #include <vector>
 
-class Field;
-
 namespace permutation {
 
+// clue pairs with more permutations are solved on their Mdd instead of a
+// list of their permutations
+constexpr std::uint64_t maxListPermutations = 1 << 20;
+
+/*
+    The permutations of the shared PermutationTable which fit to the clue
+    pairs and to the values which are still possible in the rows of one
+    board. Clue pairs with too many permutations only get their Mdd.
+*/
 class Permutations {
 public:
     Permutations(std::size_t size, Span<CluePair> cluePairs, Span<Row> rows);
 
-    Span<int> operator[](std::size_t permutationIndex) const;
+    PermutationList permutationList(std::size_t cluePairIndex) const;
 
-    std::vector<std::size_t> permutationIndexs(std::size_t cluePairIndex) const;
-
-private:
-    void addSequenceToCluePairs(const std::vector<int> &sequence,
-                                int currIndex);
+    // empty if the clue pair uses a permutation list
+    MddView mdd(std::size_t cluePairIndex) const;
 
-    bool permutationFitsCluePair(const CluePair &cluePair, int front, int back);
+    std::vector<PermutationIndex>
+    permutationIndexs(std::size_t cluePairIndex) const;
 
-    bool existingSkyscrapersInPermutation(std::size_t rowIdx,
-                                          const std::vector<int> &permutation);
+    // false if a row with clues has no permutation left which means the
+    // board has no solution
+    bool fitsAllCluePairs() const;
 
+private:
     Span<CluePair> mCluePairs;
-    Span<Row> mRows;
 
     std::size_t mSize;
-    std::size_t mPermutationCount;
-    std::vector<std::vector<std::size_t>> mCluePairsPermutationIndexes;
-
-    std::vector<int> mPermutations;
+    std::vector<PermutationList> mPermutationLists;
+    std::vector<MddView> mMdds;
+    bool mFitsAllCluePairs{true};
+    std::vector<std::vector<PermutationIndex>> mCluePairsPermutationIndexes;
 };
 
-int factorial(int n);
-
-template <typename BuildingIt>
-int buildingsVisible(BuildingIt begin, BuildingIt end)
-{
-    int visibleBuildingsCount = 0;
-    int highestSeen = 0;
-
-    for (auto it = begin; it != end; ++it) {
-        if (*it > highestSeen) {
-            ++visibleBuildingsCount;
-            highestSeen = *it;
-        }
-    }
-    return visibleBuildingsCount;
-}
-
 } // namespace permutation
 
 #endif
@@ -0,0 +1,269 @@
+#include "permutationtable.h"
+
+#include "../shared/visibility.h"
+#include "cluepair.h"
+#include "mdd.h"
+#include "saturating.h"
+#include "tablefile.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+namespace permutation {
+
+namespace {
+
+/*
+    Depth first search over the permutations which show front and back
+    visible buildings. A branch is dropped as soon as a clue cannot be
+    reached anymore.
+*/
+class BucketGenerator {
+public:
+    BucketGenerator(std::size_t size, int front, int back,
+                    std::vector<PermutationWord> &permutations)
+        : mSize{size}, mFront{front}, mBack{back}, mSequence(size),
+          mPermutations{permutations}
+    {
+    }
+
+    void generate()
+    {
+        addPermutations(0, fullBitmask(mSize), 0, 0, 0);
+    }
+
+private:
+    void addPermutations(std::size_t idx, BitmaskType unusedValues,
+                         int tallest, int frontVisible, int backVisible)
+    {
+        if (idx == mSize) {
+            packPermutation(mSequence, mPermutations);
+            return;
+        }
+
+        auto tallestUnused = bitWidth(unusedValues);
+
+        for (auto values = unusedValues; values != BitmaskType{};
+             values = clearLowestBit(values)) {
+            auto value = countTrailingZeros(values) + 1;
+
+            auto nextUnusedValues =
+                static_cast<BitmaskType>(unusedValues & ~valueBitmask(value));
+            auto nextTallest = std::max(tallest, value);
+            auto nextFrontVisible = frontVisible + (value > tallest ? 1 : 0);
+            auto nextBackVisible =
+                backVisible + (value == tallestUnused ? 1 : 0);
+
+            if (!cluesReachable(mFront, mBack, nextUnusedValues, nextTallest,
+                                nextFrontVisible, nextBackVisible)) {
+                continue;
+            }
+            mSequence[idx] = value;
+            addPermutations(idx + 1, nextUnusedValues, nextTallest,
+                            nextFrontVisible, nextBackVisible);
+        }
+    }
+
+    std::size_t mSize;
+    int mFront;
+    int mBack;
+    std::vector<int> mSequence;
+    std::vector<PermutationWord> &mPermutations;
+};
+
+} // namespace
+
+PermutationList::PermutationList(const PermutationWord *permutations,
+                                 std::size_t count, std::size_t size,
+                                 bool reversed)
+    : mPermutations{permutations}, mCount{count}, mSize{size},
+      mReversed{reversed}
+{
+}
+
+std::size_t PermutationList::count() const
+{
+    return mCount;
+}
+
+std::size_t PermutationList::size() const
+{
+    return mSize;
+}
+
+bool PermutationList::isReversed() const
+{
+    return mReversed;
+}
+
+const PermutationWord *PermutationList::words() const
+{
+    return mPermutations;
+}
+
+void packPermutation(const std::vector<int> &sequence,
+                     std::vector<PermutationWord> &permutations)
+{
+    if constexpr (packedPermutations) {
+        PermutationWord permutation{};
+        for (std::size_t idx = 0; idx < sequence.size(); ++idx) {
+            permutation |= static_cast<PermutationWord>(sequence[idx] - 1)
+                           << (4 * idx);
+        }
+        permutations.emplace_back(permutation);
+    }
+    else {
+        for (auto value : sequence) {
+            permutations.emplace_back(static_cast<PermutationWord>(value));
+        }
+    }
+}
+
+const PermutationTable &PermutationTable::forSize(std::size_t size)
+{
+    assert(size > 0 && size <= maxBoardSize);
+
+    static std::array<std::once_flag, maxBoardSize + 1> created;
+    static std::array<std::unique_ptr<PermutationTable>, maxBoardSize + 1>
+        tables;
+
+    std::call_once(created[size], [size] {
+        tables[size].reset(new PermutationTable(size));
+    });
+    return *tables[size];
+}
+
+PermutationList PermutationTable::permutations(const CluePair &cluePair) const
+{
+    if (cluePair.isEmpty()) {
+        return PermutationList{};
+    }
+    auto front = cluePair.frontIsEmpty() ? 0 : cluePair.front();
+    auto back = cluePair.backIsEmpty() ? 0 : cluePair.back();
+
+    auto reversed = front > back;
+    if (reversed) {
+        std::swap(front, back);
+    }
+    const auto &permutations = bucket(front, back);
+    auto count = packedPermutations ? permutations.wordCount
+                                    : permutations.wordCount / mSize;
+    return PermutationList{permutations.words, count, mSize, reversed};
+}
+
+std::uint64_t
+PermutationTable::permutationCount(const CluePair &cluePair) const
+{
+    auto front = cluePair.frontIsEmpty() ? 0 : cluePair.front();
+    auto back = cluePair.backIsEmpty() ? 0 : cluePair.back();
+
+    auto n = mSize;
+    auto stirling = [&](std::size_t i, std::size_t k) {
+        return mStirlingNumbers[i * (n + 1) + k];
+    };
+
+    if (front == 0 && back == 0) {
+        std::uint64_t count = 1;
+        for (std::size_t i = 2; i <= n; ++i) {
+            count = saturatingMultiply(count, i);
+        }
+        return count;
+    }
+    if (front == 0 || back == 0) {
+        return stirling(n, front + back);
+    }
+    // the tallest value splits the row into the values seen from the front
+    // and the values seen from the back. The n - 1 other values form
+    // front + back - 2 cycles, any front - 1 of them go to the front
+    auto cycles = static_cast<std::size_t>(front + back - 2);
+    if (cycles > n - 1) {
+        return 0;
+    }
+    std::vector<std::uint64_t> binomials(cycles + 1, 0);
+    binomials[0] = 1;
+    for (std::size_t i = 1; i <= cycles; ++i) {
+        for (auto k = i; k > 0; --k) {
+            binomials[k] = saturatingAdd(binomials[k], binomials[k - 1]);
+        }
+    }
+    return saturatingMultiply(binomials[front - 1], stirling(n - 1, cycles));
+}
+
+MddView PermutationTable::mdd(const CluePair &cluePair) const
+{
+    if (cluePair.isEmpty() || mSize > Mdd::maxSize) {
+        return MddView{};
+    }
+    auto front = cluePair.frontIsEmpty() ? 0 : cluePair.front();
+    auto back = cluePair.backIsEmpty() ? 0 : cluePair.back();
+
+    auto reversed = front > back;
+    if (reversed) {
+        std::swap(front, back);
+    }
+    auto &slot = mMdds[front * (mSize + 1) + back];
+    std::call_once(slot.built, [&] {
+        slot.mdd = std::make_unique<Mdd>(mSize, front, back);
+    });
+    return MddView{slot.mdd.get(), reversed};
+}
+
+PermutationTable::PermutationTable(std::size_t size)
+    : mSize{size}, mBuckets{new Bucket[(size + 1) * (size + 1)]},
+      mMdds{new MddSlot[(size + 1) * (size + 1)]},
+      mStirlingNumbers((size + 1) * (size + 1), 0)
+{
+    // unsigned Stirling numbers of the first kind count the permutations
+    // of i values with k of them visible from one side
+    auto stirling = [&](std::size_t i, std::size_t k) -> std::uint64_t & {
+        return mStirlingNumbers[i * (size + 1) + k];
+    };
+    stirling(0, 0) = 1;
+    for (std::size_t i = 1; i <= size; ++i) {
+        for (std::size_t k = 1; k <= i; ++k) {
+            stirling(i, k) = saturatingAdd(
+                stirling(i - 1, k - 1),
+                saturatingMultiply(i - 1, stirling(i - 1, k)));
+        }
+    }
+}
+
+PermutationTable::~PermutationTable() = default;
+
+const PermutationTable::Bucket &PermutationTable::bucket(int front,
+                                                         int back) const
+{
+    assert(front <= back);
+    assert(back <= static_cast<int>(mSize));
+
+    auto &bucket = mBuckets[front * (mSize + 1) + back];
+    std::call_once(bucket.generated, [&] { generate(bucket, front, back); });
+    return bucket;
+}
+
+void PermutationTable::generate(Bucket &bucket, int front, int back) const
+{
+    const auto &directory = tableCacheDirectory();
+    if (!directory.empty()) {
+        auto file = std::make_unique<MappedTableFile>();
+        if (file->open(directory, mSize, front, back)) {
+            bucket.words = file->words();
+            bucket.wordCount = file->wordCount();
+            bucket.file = std::move(file);
+            return;
+        }
+    }
+
+    BucketGenerator{mSize, front, back, bucket.permutations}.generate();
+    assert(bucket.permutations.size() <=
+           std::numeric_limits<PermutationIndex>::max());
+    bucket.words = bucket.permutations.data();
+    bucket.wordCount = bucket.permutations.size();
+
+    if (!directory.empty()) {
+        writeTableFile(directory, mSize, front, back, bucket.permutations);
+    }
+}
+
+} // namespace permutation
@@ -0,0 +1,139 @@
+#ifndef PERMUTATION_PERMUTATIONTABLE_H
+#define PERMUTATION_PERMUTATIONTABLE_H
+
+#include "../shared/bitmask.h"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace permutation {
+
+class CluePair;
+class MappedTableFile;
+class Mdd;
+class MddView;
+
+/*
+    With SKYSCRAPERS_MAX_BOARD_SIZE <= 16 a permutation is packed into one
+    std::uint64_t with 4 bits per field holding value - 1. Bigger boards use
+    one std::uint16_t per field.
+*/
+constexpr bool packedPermutations = maxBoardSize <= 16;
+
+using PermutationWord =
+    std::conditional_t<packedPermutations, std::uint64_t, std::uint16_t>;
+
+// index of a permutation in a PermutationList
+using PermutationIndex = std::uint32_t;
+
+// The permutations which fit to one clue pair. A reversed list reads the
+// permutations of the mirrored clue pair from the back.
+class PermutationList {
+public:
+    PermutationList() = default;
+    PermutationList(const PermutationWord *permutations, std::size_t count,
+                    std::size_t size, bool reversed);
+
+    std::size_t count() const;
+    std::size_t size() const;
+    bool isReversed() const;
+
+    // the permutations as stored in the table
+    const PermutationWord *words() const;
+
+    // value on field idx of the permutation
+    int value(PermutationIndex permutationIdx, std::size_t idx) const
+    {
+        assert(permutationIdx < mCount);
+        assert(idx < mSize);
+        if (mReversed) {
+            idx = mSize - 1 - idx;
+        }
+        if constexpr (packedPermutations) {
+            return static_cast<int>(
+                       (mPermutations[permutationIdx] >> (4 * idx)) & 0xf) +
+                   1;
+        }
+        else {
+            return mPermutations[permutationIdx * mSize + idx];
+        }
+    }
+
+private:
+    const PermutationWord *mPermutations{nullptr};
+    std::size_t mCount{0};
+    std::size_t mSize{0};
+    bool mReversed{false};
+};
+
+// appends the values 1 to size in sequence to permutations in the layout
+// PermutationList reads them
+void packPermutation(const std::vector<int> &sequence,
+                     std::vector<PermutationWord> &permutations);
+
+/*
+    All permutations of the values 1 to size bucketed by the buildings
+    visible from the front and the back, 0 stands for a missing clue.
+
+    A bucket is generated on first use and never changes afterwards so one
+    table per size is shared by all boards and threads. Only buckets with
+    front <= back are stored, the mirrored clue pair reuses them reversed.
+    With the on disk cache of tablefile.h a bucket is mapped from its file
+    instead and only generated and written if there is no valid file yet.
+
+    The Mdd of a clue pair is shared the same way, also only for
+    front <= back.
+*/
+class PermutationTable {
+public:
+    static const PermutationTable &forSize(std::size_t size);
+
+    ~PermutationTable();
+
+    // empty for an empty clue pair
+    PermutationList permutations(const CluePair &cluePair) const;
+
+    // counted without generating the bucket, saturates at the maximum of
+    // std::uint64_t
+    std::uint64_t permutationCount(const CluePair &cluePair) const;
+
+    // empty for an empty clue pair or a board bigger than Mdd::maxSize
+    MddView mdd(const CluePair &cluePair) const;
+
+private:
+    explicit PermutationTable(std::size_t size);
+
+    struct Bucket {
+        std::once_flag generated;
+        // points into permutations or into file
+        const PermutationWord *words{nullptr};
+        std::size_t wordCount{0};
+        std::vector<PermutationWord> permutations;
+        std::unique_ptr<MappedTableFile> file;
+    };
+
+    void generate(Bucket &bucket, int front, int back) const;
+
+    const Bucket &bucket(int front, int back) const;
+
+    struct MddSlot {
+        std::once_flag built;
+        std::unique_ptr<Mdd> mdd;
+    };
+
+    std::size_t mSize;
+    // at front * (size + 1) + back
+    std::unique_ptr<Bucket[]> mBuckets;
+    // at front * (size + 1) + back with front <= back
+    std::unique_ptr<MddSlot[]> mMdds;
+    // unsigned Stirling numbers of the first kind at i * (size + 1) + k
+    std::vector<std::uint64_t> mStirlingNumbers;
+};
+
+} // namespace permutation
+
+#endif
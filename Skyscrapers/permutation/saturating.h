@@ -0,0 +1,28 @@
+#ifndef PERMUTATION_SATURATING_H
+#define PERMUTATION_SATURATING_H
+
+#include <cstdint>
+#include <limits>
+
+namespace permutation {
+
+// the number of permutations overflows for big boards, it stays at the
+// maximum of std::uint64_t then
+
+inline std::uint64_t saturatingAdd(std::uint64_t a, std::uint64_t b)
+{
+    auto sum = a + b;
+    return sum < a ? std::numeric_limits<std::uint64_t>::max() : sum;
+}
+
+inline std::uint64_t saturatingMultiply(std::uint64_t a, std::uint64_t b)
+{
+    if (a != 0 && b > std::numeric_limits<std::uint64_t>::max() / a) {
+        return std::numeric_limits<std::uint64_t>::max();
+    }
+    return a * b;
+}
+
+} // namespace permutation
+
+#endif
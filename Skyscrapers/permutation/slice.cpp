@@ -4,27 +4,37 @@
 #include "../shared/row.h"
 #include "permutations.h"
 
+#include <cassert>
+
 namespace permutation {
 
-Slice::Slice(Permutations &permutations,
-             const std::vector<std::size_t> &permutationIndexes, Row &row,
+Slice::Slice(const PermutationList &permutationList,
+             const std::vector<PermutationIndex> &permutationIndexes, Row &row,
              std::size_t size)
-    : mPermutations{&permutations},
-      mPermutationIndexes{permutationIndexes}, mRow{&row}
+    : mRow{&row}
 {
     if (permutationIndexes.empty()) {
         return;
     }
+    addSupports(permutationList, permutationIndexes, size);
+    mRow->addFieldData(supportedValues(size));
+}
 
-    auto possibleBuildings = getPossibleBuildings(size);
-    auto fieldElements = getFieldElements(possibleBuildings);
+Slice::Slice(const MddView &mdd, Row &row, std::size_t size)
+    : mMdd{mdd}, mRow{&row}
+{
+    if (reducePossiblePermutations(size)) {
+        mRow->addFieldData(supportedValues(size));
+    }
+}
 
-    mRow->addFieldData(fieldElements, Row::Direction::front);
+Slice::Slice(Row &row) : mWithoutClues{true}, mRow{&row}
+{
 }
 
-void Slice::guessSkyscraperOutOfNeighbourNopes()
+bool Slice::guessSkyscraperOutOfNeighbourNopes()
 {
-    mRow->guessSkyscraperOutOfNeighbourNopes();
+    return mRow->guessSkyscraperOutOfNeighbourNopes();
 }
 
 bool Slice::isSolved() const
@@ -32,125 +42,280 @@ bool Slice::isSolved() const
     return mRow->allFieldsContainSkyscraper();
 }
 
-void Slice::solveFromPossiblePermutations(std::size_t size)
+bool Slice::isDirty() const
 {
-    if (mPermutationIndexes.empty()) {
-        return;
-    }
-
-    while (reducePossiblePermutations(size)) {
-        auto lastFields = copyFields(size);
-
-        auto possibleBuildings = getPossibleBuildings(size);
-        auto fieldElements = getFieldElements(possibleBuildings);
-
-        mRow->addFieldData(fieldElements, Row::Direction::front);
+    return mRow->epoch() != mSolvedEpoch;
+}
 
-        if (fieldsIdentical(lastFields, size)) {
-            break;
-        }
+std::uint64_t Slice::permutationCount() const
+{
+    if (mMdd) {
+        return mMddPermutationCount;
     }
+    return mPossiblePermutations.count();
 }
 
-bool Slice::reducePossiblePermutations(std::size_t size)
+bool Slice::solveFromPossiblePermutations(std::size_t size)
 {
-    auto startSize = mPermutationIndexes.size();
-    auto it = mPermutationIndexes.begin();
-
-    while (it != mPermutationIndexes.end()) {
-
-        if (!isValidPermutation(mPermutations->operator[](*it), size)) {
-            it = mPermutationIndexes.erase(it);
+    if (!hasPermutations()) {
+        if (!generateFromFields(size)) {
+            mSolvedEpoch = mRow->epoch();
+            return true;
         }
-        else {
-            ++it;
+        // no distinct values fit to the fields
+        if (!hasPermutations()) {
+            return false;
         }
     }
 
-    return startSize > mPermutationIndexes.size();
-}
-
-std::vector<std::set<int>> Slice::getPossibleBuildings(std::size_t size) const
-{
-    std::vector<std::set<int>> possibleBuildingsOnFields(size);
-
-    for (const auto &permutationIndex : mPermutationIndexes) {
-
-        auto permutation = mPermutations->operator[](permutationIndex);
-        for (std::size_t i = 0; i < permutation.size(); ++i) {
-            possibleBuildingsOnFields[i].insert(permutation[i]);
+    for (;;) {
+        if (!reducePossiblePermutations(size)) {
+            return false;
+        }
+        auto values = supportedValues(size);
+        if (values == mDomains) {
+            break;
+        }
+        if (!mRow->addFieldData(values)) {
+            return false;
         }
     }
-    return possibleBuildingsOnFields;
+    mSolvedEpoch = mRow->epoch();
+    return true;
 }
 
-std::vector<Field> Slice::copyFields(std::size_t size) const
+void Slice::addSupports(const PermutationList &permutationList,
+                        const std::vector<PermutationIndex> &permutationIndexes,
+                        std::size_t size)
 {
-    std::vector<Field> result;
-    result.reserve(size);
-
+    mPermutationCount = permutationIndexes.size();
+    mPossiblePermutations = SparseBitset{permutationIndexes.size()};
+
+    auto wordCount = mPossiblePermutations.wordCount();
+    mSupports.assign(size * size * wordCount, 0);
+    mResidues.assign(size * size, 0);
+
+    for (std::size_t bit = 0; bit < permutationIndexes.size(); ++bit) {
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            auto value = permutationList.value(permutationIndexes[bit], idx);
+            auto word = (idx * size + value - 1) * wordCount + bit / 64;
+            mSupports[word] |= std::uint64_t{1} << (bit % 64);
+        }
+    }
+    // the permutations were chosen to fit to the fields
     for (std::size_t idx = 0; idx < size; ++idx) {
-        result.emplace_back(mRow->getFieldRef(idx));
+        mDomains[idx] = fullBitmask(size);
     }
-    return result;
 }
 
-bool Slice::fieldsIdentical(const std::vector<Field> &lastFields,
-                            std::size_t size) const
+bool Slice::generateFromFields(std::size_t size)
 {
-    assert(lastFields.size() == size);
+    if (!mWithoutClues) {
+        return false;
+    }
 
+    RowMasks domains{};
+    std::uint64_t combinations = 1;
     for (std::size_t idx = 0; idx < size; ++idx) {
-        if (lastFields[idx] != mRow->getFieldRef(idx)) {
+        domains[idx] = fieldValues(idx, size);
+        combinations *= popCount(domains[idx]);
+        if (combinations > maxFieldPermutations) {
             return false;
         }
     }
+
+    mGeneratedPermutations.clear();
+    std::vector<int> sequence(size);
+    std::vector<BitmaskType> unusedValues(size + 1);
+    unusedValues[0] = fullBitmask(size);
+
+    // iterative depth first search, remaining[idx] holds the values of
+    // field idx which are not tried yet
+    auto remaining = domains;
+    std::size_t idx = 0;
+    remaining[0] = static_cast<BitmaskType>(domains[0] & unusedValues[0]);
+    for (;;) {
+        if (remaining[idx] == BitmaskType{}) {
+            if (idx == 0) {
+                break;
+            }
+            --idx;
+            continue;
+        }
+        auto value = countTrailingZeros(remaining[idx]) + 1;
+        remaining[idx] = clearLowestBit(remaining[idx]);
+        sequence[idx] = value;
+
+        if (idx + 1 == size) {
+            packPermutation(sequence, mGeneratedPermutations);
+            continue;
+        }
+        unusedValues[idx + 1] =
+            static_cast<BitmaskType>(unusedValues[idx] & ~valueBitmask(value));
+        ++idx;
+        remaining[idx] =
+            static_cast<BitmaskType>(domains[idx] & unusedValues[idx]);
+    }
+
+    auto count = packedPermutations ? mGeneratedPermutations.size()
+                                    : mGeneratedPermutations.size() / size;
+    std::vector<PermutationIndex> permutationIndexes(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        permutationIndexes[i] = static_cast<PermutationIndex>(i);
+    }
+    addSupports(PermutationList{mGeneratedPermutations.data(), count, size,
+                                false},
+                permutationIndexes, size);
     return true;
 }
 
-bool Slice::isValidPermutation(const Span<int> &permutation,
-                               std::size_t size) const
+void Slice::dropGeneratedPermutations()
 {
-    assert(permutation.size() == size);
+    mPermutationCount = 0;
+    mPossiblePermutations = SparseBitset{0};
+    mSupports.clear();
+    mResidues.clear();
+    mDomains = RowMasks{};
+    mGeneratedPermutations.clear();
+}
+
+bool Slice::reducePossiblePermutations(std::size_t size)
+{
+    auto full = fullBitmask(size);
+    auto fieldMasks = mRow->fieldMasks();
+
+    if (mMdd) {
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            mDomains[idx] = static_cast<BitmaskType>(fieldMasks[idx] & full);
+        }
+        mMddPermutationCount =
+            mMdd.supportedValues(mDomains, mMddSupported, mMddScratch);
+        return mMddPermutationCount != 0;
+    }
 
     for (std::size_t idx = 0; idx < size; ++idx) {
-        if (mRow->getFieldRef(idx).hasSkyscraper()) {
-            if (mRow->getFieldRef(idx).skyscraper(size) != permutation[idx]) {
-                return false;
+        auto domain = static_cast<BitmaskType>(fieldMasks[idx] & full);
+        if (domain == mDomains[idx]) {
+            continue;
+        }
+        auto removed = static_cast<BitmaskType>(mDomains[idx] & ~domain);
+        mDomains[idx] = domain;
+
+        // whatever needs less bitsets, the removed or the remaining values
+        mPossiblePermutations.clearMask();
+        if (popCount(removed) < popCount(domain)) {
+            for (auto values = removed; values != BitmaskType{};
+                 values = clearLowestBit(values)) {
+                mPossiblePermutations.addToMask(
+                    supports(idx, countTrailingZeros(values) + 1, size));
             }
+            mPossiblePermutations.reverseMask();
         }
-        else if (!mRow->getFieldRef(idx).nopes(size).empty()) {
-            if (mRow->getFieldRef(idx).containsNope(permutation[idx])) {
-                return false;
+        else {
+            for (auto values = domain; values != BitmaskType{};
+                 values = clearLowestBit(values)) {
+                mPossiblePermutations.addToMask(
+                    supports(idx, countTrailingZeros(values) + 1, size));
             }
         }
+        mPossiblePermutations.intersectWithMask();
+
+        if (mPossiblePermutations.isEmpty()) {
+            return false;
+        }
     }
     return true;
 }
 
-std::vector<Field>
-Slice::getFieldElements(const std::vector<std::set<int>> &possibleBuildings)
+RowMasks Slice::supportedValues(std::size_t size)
 {
-    std::vector<Field> fieldElements(possibleBuildings.size(), Field{});
+    if (mMdd) {
+        return mMddSupported;
+    }
 
-    for (std::size_t i = 0; i < possibleBuildings.size(); ++i) {
-        if (possibleBuildings[i].size() == 1) {
-            fieldElements[i].insertSkyscraper(*possibleBuildings[i].begin());
-        }
-        else {
-            std::vector<int> nopes;
-            nopes.reserve(possibleBuildings.size());
-            for (std::size_t j = 0; j < possibleBuildings.size(); ++j) {
-                auto it = possibleBuildings[i].find(j + 1);
+    RowMasks supported{};
 
-                if (it == possibleBuildings[i].end()) {
-                    nopes.emplace_back(j + 1);
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        for (auto values = mDomains[idx]; values != BitmaskType{};
+             values = clearLowestBit(values)) {
+            auto value = countTrailingZeros(values) + 1;
+            auto valueSupports = supports(idx, value, size);
+
+            auto &lastWord = residue(idx, value, size);
+            if ((mPossiblePermutations.word(lastWord) &
+                 valueSupports[lastWord]) == 0) {
+                auto word = mPossiblePermutations.intersectIndex(valueSupports);
+                if (word < 0) {
+                    continue;
                 }
+                lastWord = word;
             }
-            fieldElements[i].insertNopes(nopes);
+            supported[idx] |= valueBitmask(value);
         }
     }
-    return fieldElements;
+    return supported;
+}
+
+bool Slice::hasPermutations() const
+{
+    return static_cast<bool>(mMdd) || mPermutationCount != 0;
+}
+
+std::size_t Slice::branchField(std::size_t size) const
+{
+    std::size_t bestIdx = size;
+    int bestCount = 0;
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto count = popCount(fieldValues(idx, size));
+        if (count > 1 && (bestIdx == size || count < bestCount)) {
+            bestIdx = idx;
+            bestCount = count;
+        }
+    }
+    assert(bestIdx < size);
+    return bestIdx;
+}
+
+BitmaskType Slice::fieldValues(std::size_t idx, std::size_t size) const
+{
+    return static_cast<BitmaskType>(mRow->getFieldRef(idx).bitmask() &
+                                    fullBitmask(size));
+}
+
+bool Slice::guessSkyscraper(std::size_t idx, int skyscraper)
+{
+    return mRow->addSkyscraper(idx, skyscraper);
+}
+
+Slice::State Slice::state() const
+{
+    return State{mPossiblePermutations, mDomains, mMddSupported,
+                 mMddPermutationCount, mSolvedEpoch, mPermutationCount};
+}
+
+void Slice::restore(const State &state)
+{
+    // generated out of fields which are wider again
+    if (mPermutationCount != state.permutationCount) {
+        dropGeneratedPermutations();
+    }
+    mPossiblePermutations = state.possiblePermutations;
+    mDomains = state.domains;
+    mMddSupported = state.mddSupported;
+    mMddPermutationCount = state.mddPermutationCount;
+    mSolvedEpoch = state.solvedEpoch;
+}
+
+const std::uint64_t *Slice::supports(std::size_t idx, int value,
+                                     std::size_t size) const
+{
+    return &mSupports[(idx * size + value - 1) *
+                      mPossiblePermutations.wordCount()];
+}
+
+int &Slice::residue(std::size_t idx, int value, std::size_t size)
+{
+    return mResidues[idx * size + value - 1];
 }
 
 std::vector<Slice> makeSlices(Permutations &permutations,
@@ -162,8 +327,17 @@ std::vector<Slice> makeSlices(Permutations &permutations,
     slices.reserve(rows.size());
 
     for (std::size_t i = 0; i < cluePairs.size(); ++i) {
-        slices.emplace_back(Slice{
-            permutations, permutations.permutationIndexs(i), rows[i], size});
+        if (cluePairs[i].isEmpty()) {
+            slices.emplace_back(Slice{rows[i]});
+        }
+        else if (auto mdd = permutations.mdd(i)) {
+            slices.emplace_back(Slice{mdd, rows[i], size});
+        }
+        else {
+            slices.emplace_back(Slice{permutations.permutationList(i),
+                                      permutations.permutationIndexs(i),
+                                      rows[i], size});
+        }
     }
 
     return slices;
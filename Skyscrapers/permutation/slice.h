@@ -1,9 +1,13 @@
 #ifndef PERMUTATION_SLICE_H
 #define PERMUTATION_SLICE_H
 
-#include "span.h"
+#include "../shared/rowkernels.h"
+#include "mdd.h"
+#include "permutationtable.h"
+#include "sparsebitset.h"
 
-#include <set>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 class Field;
@@ -11,40 +15,113 @@ class Row;
 
 namespace permutation {
 
-class FieldElements;
 class Permutations;
 class CluePair;
 
+// a row without clues gets its permutations out of its fields once there
+// are at most this many combinations of their values left
+constexpr std::uint64_t maxFieldPermutations = 1 << 12;
+
+/*
+    The permutations which still fit to one row are kept as compact table.
+    For every value on every field a bitset of the permutations which have
+    it is precomputed. If a field loses values the possible permutations
+    are reduced with word wide operations on these bitsets. A value stays
+    on a field as long as its bitset intersects the possible permutations,
+    the word of the last intersection is remembered to check it first.
+
+    Clue pairs with too many permutations for a list use their Mdd instead.
+    The values of the fields are then filtered with a forward and backward
+    reachability pass over the diagram.
+
+    A row without clues has no permutations at first. As soon as its fields
+    are narrow enough the permutations of distinct values which fit to them
+    are generated and the row is filtered like a row with clues.
+*/
 class Slice {
 public:
-    Slice(Permutations &permutations,
-          const std::vector<std::size_t> &permutationIndexes, Row &row,
+    Slice(const PermutationList &permutationList,
+          const std::vector<PermutationIndex> &permutationIndexes, Row &row,
           std::size_t size);
+    Slice(const MddView &mdd, Row &row, std::size_t size);
+    // row without clues
+    explicit Slice(Row &row);
 
-    void guessSkyscraperOutOfNeighbourNopes();
+    // both return false if the board ends up with a contradiction
+    bool guessSkyscraperOutOfNeighbourNopes();
 
     bool isSolved() const;
 
-    void solveFromPossiblePermutations(std::size_t size);
+    // a field of the row changed since the last
+    // solveFromPossiblePermutations()
+    bool isDirty() const;
+
+    // permutations which fitted to the row at the last filtering
+    std::uint64_t permutationCount() const;
+
+    bool solveFromPossiblePermutations(std::size_t size);
+
+    // false for a row without clues as long as its fields are too wide to
+    // generate its permutations
+    bool hasPermutations() const;
+
+    // field without skyscraper with the fewest values left
+    std::size_t branchField(std::size_t size) const;
+    BitmaskType fieldValues(std::size_t idx, std::size_t size) const;
+    // false if the board ends up with a contradiction
+    bool guessSkyscraper(std::size_t idx, int skyscraper);
+
+    // what changes while the fields are narrowed, to go back to it after a
+    // guess failed
+    struct State {
+        SparseBitset possiblePermutations;
+        RowMasks domains;
+        RowMasks mddSupported;
+        std::uint64_t mddPermutationCount;
+        std::uint64_t solvedEpoch;
+        std::size_t permutationCount;
+    };
+    State state() const;
+    void restore(const State &state);
 
+private:
+    void addSupports(const PermutationList &permutationList,
+                     const std::vector<PermutationIndex> &permutationIndexes,
+                     std::size_t size);
+
+    // for a row without clues, false if its fields are still too wide
+    bool generateFromFields(std::size_t size);
+    void dropGeneratedPermutations();
+
+    // false if no permutation fits to the fields anymore
     bool reducePossiblePermutations(std::size_t size);
 
-private:
-    std::vector<std::set<int>> getPossibleBuildings(std::size_t size) const;
+    // values on every field which are still part of a possible permutation
+    RowMasks supportedValues(std::size_t size);
+
+    const std::uint64_t *supports(std::size_t idx, int value,
+                                  std::size_t size) const;
+
+    int &residue(std::size_t idx, int value, std::size_t size);
 
-    std::vector<Field> copyFields(std::size_t size) const;
+    std::size_t mPermutationCount{0};
+    SparseBitset mPossiblePermutations;
+    // bitsets of the permutations with value on field idx
+    std::vector<std::uint64_t> mSupports;
+    std::vector<int> mResidues;
+    // field bitmasks the possible permutations were reduced with
+    RowMasks mDomains{};
 
-    bool fieldsIdentical(const std::vector<Field> &lastFields,
-                         std::size_t size) const;
+    bool mWithoutClues{false};
+    std::vector<PermutationWord> mGeneratedPermutations;
 
-    bool isValidPermutation(const Span<int> &permutation,
-                            std::size_t size) const;
+    MddView mMdd;
+    RowMasks mMddSupported{};
+    std::uint64_t mMddPermutationCount{0};
+    MddScratch mMddScratch;
 
-    std::vector<Field>
-    getFieldElements(const std::vector<std::set<int>> &possibleBuildings);
+    std::uint64_t mSolvedEpoch{std::numeric_limits<std::uint64_t>::max()};
 
-    Permutations *mPermutations;
-    std::vector<std::size_t> mPermutationIndexes;
     Row *mRow;
 };
 
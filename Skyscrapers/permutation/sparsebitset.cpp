@@ -0,0 +1,89 @@
+#include "sparsebitset.h"
+
+#include "../shared/bitmask.h"
+
+#include <numeric>
+#include <utility>
+
+namespace permutation {
+
+SparseBitset::SparseBitset(std::size_t bitCount)
+    : mWords((bitCount + 63) / 64, ~std::uint64_t{}),
+      mMask(mWords.size()), mIndex(mWords.size()), mLimit{mWords.size()}
+{
+    if (bitCount % 64 != 0) {
+        mWords.back() = (std::uint64_t{1} << (bitCount % 64)) - 1;
+    }
+    std::iota(mIndex.begin(), mIndex.end(), 0);
+}
+
+bool SparseBitset::isEmpty() const
+{
+    return mLimit == 0;
+}
+
+std::size_t SparseBitset::count() const
+{
+    std::size_t bits = 0;
+    for (std::size_t i = 0; i < mLimit; ++i) {
+        bits += popCount(mWords[mIndex[i]]);
+    }
+    return bits;
+}
+
+std::size_t SparseBitset::wordCount() const
+{
+    return mWords.size();
+}
+
+std::uint64_t SparseBitset::word(std::size_t idx) const
+{
+    return mWords[idx];
+}
+
+void SparseBitset::clearMask()
+{
+    for (std::size_t i = 0; i < mLimit; ++i) {
+        mMask[mIndex[i]] = 0;
+    }
+}
+
+void SparseBitset::reverseMask()
+{
+    for (std::size_t i = 0; i < mLimit; ++i) {
+        mMask[mIndex[i]] = ~mMask[mIndex[i]];
+    }
+}
+
+void SparseBitset::addToMask(const std::uint64_t *words)
+{
+    for (std::size_t i = 0; i < mLimit; ++i) {
+        mMask[mIndex[i]] |= words[mIndex[i]];
+    }
+}
+
+void SparseBitset::intersectWithMask()
+{
+    for (std::size_t i = mLimit; i > 0; --i) {
+        auto idx = mIndex[i - 1];
+        mWords[idx] &= mMask[idx];
+        if (mWords[idx] == 0) {
+            // keep the non zero words in front
+            --mLimit;
+            std::swap(mIndex[i - 1], mIndex[mLimit]);
+        }
+    }
+}
+
+int SparseBitset::intersectIndex(const std::uint64_t *words) const
+{
+    for (std::size_t i = 0; i < mLimit; ++i) {
+        auto idx = mIndex[i];
+        if ((mWords[idx] & words[idx]) != 0) {
+            return static_cast<int>(idx);
+        }
+    }
+    return -1;
+}
+
+} // namespace permutation
@@ -0,0 +1,50 @@
+#ifndef PERMUTATION_SPARSEBITSET_H
+#define PERMUTATION_SPARSEBITSET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace permutation {
+
+/*
+    Bitset which keeps the indexes of its non zero words at the front of
+    mIndex so operations only visit words which still have bits.
+
+    Bits are removed by building up a mask with clearMask(), addToMask()
+    and reverseMask() and applying it with intersectWithMask().
+*/
+class SparseBitset {
+public:
+    SparseBitset() = default;
+    // all bits toggled
+    explicit SparseBitset(std::size_t bitCount);
+
+    bool isEmpty() const;
+
+    // toggled bits
+    std::size_t count() const;
+
+    std::size_t wordCount() const;
+
+    std::uint64_t word(std::size_t idx) const;
+
+    void clearMask();
+    void reverseMask();
+    void addToMask(const std::uint64_t *words);
+    void intersectWithMask();
+
+    // a non zero word with bits in common with words or -1 if there is none
+    int intersectIndex(const std::uint64_t *words) const;
+
+private:
+    std::vector<std::uint64_t> mWords;
+    std::vector<std::uint64_t> mMask;
+    // indexes of the non zero words are at [0, mLimit)
+    std::vector<std::size_t> mIndex;
+    std::size_t mLimit{0};
+};
+
+} // namespace permutation
+
+#endif
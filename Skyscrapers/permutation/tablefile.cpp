@@ -0,0 +1,237 @@
+#include "tablefile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SKYSCRAPERS_TABLEFILE_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace permutation {
+
+namespace {
+
+constexpr char tableFileMagic[8] = {'S', 'K', 'Y', 'P', 'E', 'R', 'M', '\0'};
+// increase on every change of the layout or of the permutation order
+constexpr std::uint32_t tableFileVersion = 2;
+// tells apart files written on a machine with another byte order
+constexpr std::uint32_t tableFileByteOrder = 0x01020304;
+
+struct TableFileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t byteOrder;
+    std::uint32_t wordBytes;
+    std::uint32_t size;
+    std::uint32_t front;
+    std::uint32_t back;
+    std::uint64_t wordCount;
+    std::uint64_t wordsChecksum;
+    // over all members before
+    std::uint64_t headerChecksum;
+};
+
+// FNV-1a
+std::uint64_t checksum(const void *data, std::size_t length)
+{
+    auto bytes = static_cast<const unsigned char *>(data);
+    std::uint64_t hash = 14695981039346656037ull;
+    for (std::size_t i = 0; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// FNV-1a on 8 bytes at a time, fast enough to check every mapped file
+std::uint64_t wordsChecksum(const PermutationWord *words,
+                            std::size_t wordCount)
+{
+    auto bytes = reinterpret_cast<const unsigned char *>(words);
+    auto length = wordCount * sizeof(PermutationWord);
+    std::uint64_t hash = 14695981039346656037ull;
+    std::size_t i = 0;
+    for (; i + sizeof(std::uint64_t) <= length; i += sizeof(std::uint64_t)) {
+        std::uint64_t chunk;
+        std::memcpy(&chunk, bytes + i, sizeof(chunk));
+        hash ^= chunk;
+        hash *= 1099511628211ull;
+    }
+    for (; i < length; ++i) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+TableFileHeader makeHeader(std::size_t size, int front, int back,
+                           std::size_t wordCount, std::uint64_t wordsChecksum)
+{
+    TableFileHeader header{};
+    std::memcpy(header.magic, tableFileMagic, sizeof(header.magic));
+    header.version = tableFileVersion;
+    header.byteOrder = tableFileByteOrder;
+    header.wordBytes = sizeof(PermutationWord);
+    header.size = static_cast<std::uint32_t>(size);
+    header.front = static_cast<std::uint32_t>(front);
+    header.back = static_cast<std::uint32_t>(back);
+    header.wordCount = wordCount;
+    header.wordsChecksum = wordsChecksum;
+    header.headerChecksum =
+        checksum(&header, offsetof(TableFileHeader, headerChecksum));
+    return header;
+}
+
+std::string tableFilePath(const std::string &directory, std::size_t size,
+                          int front, int back)
+{
+    return directory + "/permutations_" + std::to_string(size) + "_" +
+           std::to_string(front) + "_" + std::to_string(back) + ".bin";
+}
+
+} // namespace
+
+const std::string &tableCacheDirectory()
+{
+#if defined(SKYSCRAPERS_TABLEFILE_MMAP)
+    static const std::string directory = [] {
+        auto value = std::getenv("SKYSCRAPERS_PERMUTATION_CACHE");
+        return std::string{value ? value : ""};
+    }();
+#else
+    static const std::string directory;
+#endif
+    return directory;
+}
+
+MappedTableFile::~MappedTableFile()
+{
+    close();
+}
+
+bool MappedTableFile::open(const std::string &directory, std::size_t size,
+                           int front, int back)
+{
+    close();
+#if defined(SKYSCRAPERS_TABLEFILE_MMAP)
+    auto path = tableFilePath(directory, size, front, back);
+    auto fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status {};
+    if (::fstat(fd, &status) != 0 ||
+        static_cast<std::size_t>(status.st_size) < sizeof(TableFileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    mLength = static_cast<std::size_t>(status.st_size);
+    auto data = ::mmap(nullptr, mLength, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (data == MAP_FAILED) {
+        mLength = 0;
+        return false;
+    }
+    mData = data;
+
+    TableFileHeader header;
+    std::memcpy(&header, mData, sizeof(header));
+    auto words = reinterpret_cast<const PermutationWord *>(
+        static_cast<const char *>(mData) + sizeof(TableFileHeader));
+    auto wordCount = (mLength - sizeof(TableFileHeader)) /
+                     sizeof(PermutationWord);
+
+    // the words are used as indexes later so a file with a valid header
+    // but broken words must not get through. They are checked once here
+    auto expected =
+        makeHeader(size, front, back, wordCount, header.wordsChecksum);
+    auto valid =
+        std::memcmp(&header, &expected, sizeof(header)) == 0 &&
+        sizeof(TableFileHeader) + wordCount * sizeof(PermutationWord) ==
+            mLength &&
+        wordsChecksum(words, wordCount) == header.wordsChecksum;
+    if (!valid) {
+        close();
+        return false;
+    }
+    mWords = words;
+    mWordCount = wordCount;
+    return true;
+#else
+    (void)directory;
+    (void)size;
+    (void)front;
+    (void)back;
+    return false;
+#endif
+}
+
+const PermutationWord *MappedTableFile::words() const
+{
+    return mWords;
+}
+
+std::size_t MappedTableFile::wordCount() const
+{
+    return mWordCount;
+}
+
+void MappedTableFile::close()
+{
+#if defined(SKYSCRAPERS_TABLEFILE_MMAP)
+    if (mData) {
+        ::munmap(mData, mLength);
+    }
+#endif
+    mData = nullptr;
+    mLength = 0;
+    mWords = nullptr;
+    mWordCount = 0;
+}
+
+bool writeTableFile(const std::string &directory, std::size_t size, int front,
+                    int back, const std::vector<PermutationWord> &words)
+{
+#if defined(SKYSCRAPERS_TABLEFILE_MMAP)
+    auto path = tableFilePath(directory, size, front, back);
+    // other processes only ever see complete files
+    auto tmpPath = path + "." + std::to_string(::getpid()) + ".tmp";
+
+    auto header = makeHeader(size, front, back, words.size(),
+                             wordsChecksum(words.data(), words.size()));
+    {
+        std::ofstream file{tmpPath, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(words.data()),
+                   words.size() * sizeof(PermutationWord));
+        // closing flushes the rest, which can fail as well
+        file.close();
+        if (!file) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+    return true;
+#else
+    (void)directory;
+    (void)size;
+    (void)front;
+    (void)back;
+    (void)words;
+    return false;
+#endif
+}
+
+} // namespace permutation
@@ -0,0 +1,59 @@
+#ifndef PERMUTATION_TABLEFILE_H
+#define PERMUTATION_TABLEFILE_H
+
+#include "permutationtable.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace permutation {
+
+/*
+    On disk cache for the buckets of the PermutationTable. It is only used if
+    the environment variable SKYSCRAPERS_PERMUTATION_CACHE names a directory
+    and the platform supports mmap. Every bucket is one file
+
+        <directory>/permutations_<size>_<front>_<back>.bin
+
+    with a header followed by the permutation words as they are stored in
+    memory. The header holds the format version, the word width and
+    checksums of itself and the words. Opening a file checks the header,
+    the file length and the checksum of the words once. Files which do not
+    match are ignored and written again.
+*/
+
+// empty if the cache is disabled
+const std::string &tableCacheDirectory();
+
+class MappedTableFile {
+public:
+    MappedTableFile() = default;
+    ~MappedTableFile();
+
+    MappedTableFile(const MappedTableFile &) = delete;
+    MappedTableFile &operator=(const MappedTableFile &) = delete;
+
+    // false if the file is missing or does not fit to the bucket
+    bool open(const std::string &directory, std::size_t size, int front,
+              int back);
+
+    const PermutationWord *words() const;
+    std::size_t wordCount() const;
+
+private:
+    void close();
+
+    void *mData{nullptr};
+    std::size_t mLength{0};
+    const PermutationWord *mWords{nullptr};
+    std::size_t mWordCount{0};
+};
+
+// false if the file could not be written, the bucket is still usable then
+bool writeTableFile(const std::string &directory, std::size_t size, int front,
+                    int back, const std::vector<PermutationWord> &words);
+
+} // namespace permutation
+
+#endif
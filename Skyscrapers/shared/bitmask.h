@@ -0,0 +1,263 @@
+#ifndef BITMASK_H
+#define BITMASK_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/*
+    The width of the bitmask stored in every Field is chosen at build time
+    from the biggest board the engine has to solve:
+
+    SKYSCRAPERS_MAX_BOARD_SIZE <= 16 std::uint16_t
+    SKYSCRAPERS_MAX_BOARD_SIZE <= 32 std::uint32_t
+    SKYSCRAPERS_MAX_BOARD_SIZE <= 64 std::uint64_t
+    SKYSCRAPERS_MAX_BOARD_SIZE >  64 WideBitmask with 64 bit words
+*/
+
+#ifndef SKYSCRAPERS_MAX_BOARD_SIZE
+#define SKYSCRAPERS_MAX_BOARD_SIZE 16
+#endif
+
+constexpr std::size_t maxBoardSize = SKYSCRAPERS_MAX_BOARD_SIZE;
+
+template <std::size_t Words> class WideBitmask {
+public:
+    constexpr WideBitmask() = default;
+    constexpr WideBitmask(std::uint64_t lowWord) : mWords{lowWord}
+    {
+    }
+
+    constexpr std::uint64_t word(std::size_t idx) const
+    {
+        return mWords[idx];
+    }
+    constexpr std::uint64_t &word(std::size_t idx)
+    {
+        return mWords[idx];
+    }
+
+    constexpr WideBitmask &operator&=(const WideBitmask &other)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            mWords[i] &= other.mWords[i];
+        }
+        return *this;
+    }
+    constexpr WideBitmask &operator|=(const WideBitmask &other)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            mWords[i] |= other.mWords[i];
+        }
+        return *this;
+    }
+    constexpr WideBitmask &operator^=(const WideBitmask &other)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            mWords[i] ^= other.mWords[i];
+        }
+        return *this;
+    }
+    constexpr WideBitmask operator~() const
+    {
+        WideBitmask result;
+        for (std::size_t i = 0; i < Words; ++i) {
+            result.mWords[i] = ~mWords[i];
+        }
+        return result;
+    }
+
+    friend constexpr WideBitmask operator&(WideBitmask lhs,
+                                           const WideBitmask &rhs)
+    {
+        return lhs &= rhs;
+    }
+    friend constexpr WideBitmask operator|(WideBitmask lhs,
+                                           const WideBitmask &rhs)
+    {
+        return lhs |= rhs;
+    }
+    friend constexpr WideBitmask operator^(WideBitmask lhs,
+                                           const WideBitmask &rhs)
+    {
+        return lhs ^= rhs;
+    }
+    friend constexpr bool operator==(const WideBitmask &lhs,
+                                     const WideBitmask &rhs)
+    {
+        for (std::size_t i = 0; i < Words; ++i) {
+            if (lhs.mWords[i] != rhs.mWords[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    friend constexpr bool operator!=(const WideBitmask &lhs,
+                                     const WideBitmask &rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    std::array<std::uint64_t, Words> mWords{};
+};
+
+template <std::size_t Size>
+using BitmaskForSize = std::conditional_t<
+    Size <= 16, std::uint16_t,
+    std::conditional_t<
+        Size <= 32, std::uint32_t,
+        std::conditional_t<Size <= 64, std::uint64_t,
+                           WideBitmask<(Size + 63) / 64>>>>;
+
+using BitmaskType = BitmaskForSize<maxBoardSize>;
+
+constexpr std::size_t bitmaskBits = sizeof(BitmaskType) * 8;
+
+// same as c++20 std::countr_zero() but undefined for bitmask == 0
+inline int countTrailingZeros(std::uint64_t bitmask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(bitmask);
+#else
+    int count = 0;
+    for (; (bitmask & 1) == 0; bitmask >>= 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+template <std::size_t Words>
+int countTrailingZeros(const WideBitmask<Words> &bitmask)
+{
+    for (std::size_t i = 0; i < Words; ++i) {
+        if (bitmask.word(i) != 0) {
+            return i * 64 + countTrailingZeros(bitmask.word(i));
+        }
+    }
+    return Words * 64;
+}
+
+// same as c++20 std::bit_width(), the highest toggled value or 0
+inline int bitWidth(std::uint64_t bitmask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return bitmask == 0 ? 0 : 64 - __builtin_clzll(bitmask);
+#else
+    int width = 0;
+    for (; bitmask != 0; bitmask >>= 1) {
+        ++width;
+    }
+    return width;
+#endif
+}
+
+template <std::size_t Words> int bitWidth(const WideBitmask<Words> &bitmask)
+{
+    for (std::size_t i = Words; i > 0; --i) {
+        if (bitmask.word(i - 1) != 0) {
+            return (i - 1) * 64 + bitWidth(bitmask.word(i - 1));
+        }
+    }
+    return 0;
+}
+
+// same as c++20 std::popcount()
+inline int popCount(std::uint64_t bitmask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(bitmask);
+#else
+    int count = 0;
+    for (; bitmask != 0; bitmask &= bitmask - 1) {
+        ++count;
+    }
+    return count;
+#endif
+}
+
+template <std::size_t Words> int popCount(const WideBitmask<Words> &bitmask)
+{
+    int count = 0;
+    for (std::size_t i = 0; i < Words; ++i) {
+        count += popCount(bitmask.word(i));
+    }
+    return count;
+}
+
+// same as c++20 std::has_single_bit()
+template <typename Bitmask> bool hasSingleBit(const Bitmask &bitmask)
+{
+    if constexpr (std::is_integral_v<Bitmask>) {
+        return bitmask != 0 && (bitmask & (bitmask - 1)) == 0;
+    }
+    else {
+        return popCount(bitmask) == 1;
+    }
+}
+
+template <typename Bitmask> Bitmask clearLowestBit(const Bitmask &bitmask)
+{
+    if constexpr (std::is_integral_v<Bitmask>) {
+        return static_cast<Bitmask>(bitmask & (bitmask - 1));
+    }
+    else {
+        auto result = bitmask;
+        auto bit = countTrailingZeros(bitmask);
+        result.word(bit / 64) &= ~(std::uint64_t{1} << (bit % 64));
+        return result;
+    }
+}
+
+// bitmask with only the bit of value toggled, values start with 1
+template <typename Bitmask = BitmaskType>
+constexpr Bitmask valueBitmask(int value)
+{
+    if constexpr (std::is_integral_v<Bitmask>) {
+        return static_cast<Bitmask>(Bitmask{1} << (value - 1));
+    }
+    else {
+        Bitmask bitmask{};
+        bitmask.word((value - 1) / 64) = std::uint64_t{1}
+                                         << ((value - 1) % 64);
+        return bitmask;
+    }
+}
+
+// bitmask with the lowest size bits toggled
+template <typename Bitmask = BitmaskType>
+constexpr Bitmask fullBitmask(std::size_t size)
+{
+    if (size >= sizeof(Bitmask) * 8) {
+        return static_cast<Bitmask>(~Bitmask{});
+    }
+    if constexpr (std::is_integral_v<Bitmask>) {
+        return static_cast<Bitmask>((Bitmask{1} << size) - 1);
+    }
+    else {
+        Bitmask bitmask{};
+        for (std::size_t i = 0; i < size / 64; ++i) {
+            bitmask.word(i) = ~std::uint64_t{};
+        }
+        if (size % 64 != 0) {
+            bitmask.word(size / 64) = (std::uint64_t{1} << (size % 64)) - 1;
+        }
+        return bitmask;
+    }
+}
+
+// the lowest 64 values, enough for rows which are solved with a state per
+// used value
+template <typename Bitmask> std::uint64_t lowBits(const Bitmask &bitmask)
+{
+    if constexpr (std::is_integral_v<Bitmask>) {
+        return bitmask;
+    }
+    else {
+        return bitmask.word(0);
+    }
+}
+
+#endif
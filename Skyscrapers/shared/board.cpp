@@ -1,36 +1,61 @@
 #include "board.h"
 
 #include "borderiterator.h"
-#include "rowclues.h"
+#include "cluedomains.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iomanip>
 #include <iostream>
-#include <numeric>
+#include <stdexcept>
 
 Board::Board(std::size_t size)
-    : fields{std::vector<Field>(size * size, Field{})}, mSize{size}
+    : mFields{std::vector<Field>(size * size, Field{})},
+      mTransposedFields{std::vector<Field>(size * size, Field{})},
+      mRowCounters(size, RowCounters{}), mColumnCounters(size, RowCounters{}),
+      mSkyscraperCount{0}, mHasContradiction{false}, mContradictionMark{0},
+      mRowEvents(size * 2), mSize{size}
 {
+    if (mSize > maxBoardSize) {
+        throw std::invalid_argument{
+            "board size " + std::to_string(mSize) +
+            " is bigger than SKYSCRAPERS_MAX_BOARD_SIZE " +
+            std::to_string(maxBoardSize)};
+    }
+
+    // all values are possible in all fields
+    RowCounters counters;
+    std::fill(counters.candidateCounts.begin(),
+              counters.candidateCounts.begin() + mSize,
+              static_cast<int>(mSize));
+    std::fill(mRowCounters.begin(), mRowCounters.end(), counters);
+    std::fill(mColumnCounters.begin(), mColumnCounters.end(), counters);
+
     makeRows();
 }
 
-void Board::insert(const std::vector<RowClues> &rowClues)
+bool Board::insertClues(const std::vector<int> &clues)
 {
-    assert(rowClues.size() == mRows.size());
+    assert(clues.size() == mRows.size() * 2);
 
-    for (std::size_t i = 0; i < rowClues.size(); ++i) {
-        if (rowClues[i].isEmpty()) {
+    for (std::size_t i = 0; i < mRows.size(); ++i) {
+        auto front = clues[i];
+        auto back = clues[backClueIdx(i, mSize)];
+        if (front == 0 && back == 0) {
             continue;
         }
-        mRows[i].addFieldData(rowClues[i].fields, Row::Direction::front);
+        mRows[i].setClues(front, back);
+        if (!mRows[i].addFieldData(clueDomains(mSize, front, back))) {
+            return false;
+        }
     }
+    return true;
 }
 
-void Board::insert(const std::vector<std::vector<int>> &startingSkyscrapers)
+bool Board::insert(const std::vector<std::vector<int>> &startingSkyscrapers)
 {
     if (startingSkyscrapers.empty()) {
-        return;
+        return !mHasContradiction;
     }
     std::size_t boardSize = mRows.size() / 2;
     assert(startingSkyscrapers.size() == boardSize);
@@ -47,33 +72,180 @@ void Board::insert(const std::vector<std::vector<int>> &startingSkyscrapers)
             }
             fields[fieldIdx].insertSkyscraper(startingSkyscrapers[i][fieldIdx]);
         }
-        mRows[i + boardSize].addFieldData(fields, Row::Direction::back);
+        if (!mRows[i + boardSize].addFieldData(fields,
+                                               Row::Direction::back)) {
+            return false;
+        }
     }
+    return true;
 }
 
 bool Board::isSolved() const
 {
-    std::size_t endVerticalRows = mRows.size() / 2;
-    for (std::size_t i = 0; i < endVerticalRows; ++i) {
-        if (!mRows[i].allFieldsContainSkyscraper()) {
-            return false;
+    return mSkyscraperCount == mFields.size();
+}
+
+const std::vector<Field> &Board::fields() const
+{
+    return mFields;
+}
+
+const std::vector<Field> &Board::transposedFields() const
+{
+    return mTransposedFields;
+}
+
+bool Board::setField(std::size_t idx, const Field &field)
+{
+    assert(idx < mFields.size());
+
+    if (mFields[idx] == field) {
+        return !mHasContradiction;
+    }
+    mTrail.push_back({idx, mFields[idx]});
+
+    auto removedValues = static_cast<BitmaskType>(
+        mFields[idx].bitmask() & ~field.bitmask() & fullBitmask(mSize));
+    BitmaskType skyscrapers{};
+    if (field.hasSkyscraper() && !mFields[idx].hasSkyscraper()) {
+        skyscrapers = field.bitmask();
+    }
+
+    replaceField(idx, field);
+
+    // columns are the first rows, the rows of the board the second half
+    queueEvents(idx % mSize, skyscrapers, removedValues);
+    queueEvents(mSize + idx / mSize, skyscrapers, removedValues);
+
+    if (!mHasContradiction && !isConsistent(idx, removedValues)) {
+        mHasContradiction = true;
+        mContradictionMark = mTrail.size() - 1;
+    }
+    return !mHasContradiction;
+}
+
+bool Board::hasContradiction() const
+{
+    return mHasContradiction;
+}
+
+std::size_t Board::checkpoint() const
+{
+    return mTrail.size();
+}
+
+void Board::rollback(std::size_t mark)
+{
+    assert(mark <= mTrail.size());
+
+    while (mTrail.size() > mark) {
+        replaceField(mTrail.back().idx, mTrail.back().field);
+        mTrail.pop_back();
+    }
+
+    if (mHasContradiction && mark <= mContradictionMark) {
+        mHasContradiction = false;
+    }
+    // the queued events belong to changes which are gone now
+    clearEvents();
+}
+
+void Board::replaceField(std::size_t idx, const Field &field)
+{
+    auto &rowCounters = mRowCounters[idx / mSize];
+    auto &columnCounters = mColumnCounters[idx % mSize];
+
+    if (mFields[idx].hasSkyscraper()) {
+        removeSkyscraper(rowCounters, mFields[idx].skyscraper());
+        removeSkyscraper(columnCounters, mFields[idx].skyscraper());
+        --mSkyscraperCount;
+    }
+
+    auto changedValues = static_cast<BitmaskType>(
+        (mFields[idx].bitmask() ^ field.bitmask()) & fullBitmask(mSize));
+    for (; changedValues != BitmaskType{};
+         changedValues = clearLowestBit(changedValues)) {
+        int value = countTrailingZeros(changedValues) + 1;
+        if (field.containsNope(value)) {
+            removeCandidate(rowCounters, value);
+            removeCandidate(columnCounters, value);
         }
+        else {
+            addCandidate(rowCounters, value);
+            addCandidate(columnCounters, value);
+        }
+    }
+
+    mFields[idx] = field;
+    mTransposedFields[idx % mSize * mSize + idx / mSize] = field;
+
+    ++rowCounters.epoch;
+    ++columnCounters.epoch;
+
+    if (field.hasSkyscraper()) {
+        addSkyscraper(rowCounters, field.skyscraper());
+        addSkyscraper(columnCounters, field.skyscraper());
+        ++mSkyscraperCount;
+    }
+}
+
+bool Board::propagate()
+{
+    while (!mEventQueue.empty() && !mHasContradiction) {
+        auto rowIdx = mEventQueue.front();
+        mEventQueue.pop_front();
+
+        // events which come up while the row is handled queue it again
+        auto events = mRowEvents[rowIdx];
+        mRowEvents[rowIdx] = RowEvents{};
+
+        mRows[rowIdx].propagate(events.skyscrapers, events.removedValues);
+    }
+
+    if (mHasContradiction) {
+        clearEvents();
+        return false;
     }
     return true;
 }
 
+const RowCounters &Board::rowCounters(std::size_t row) const
+{
+    return mRowCounters[row];
+}
+
+const RowCounters &Board::columnCounters(std::size_t column) const
+{
+    return mColumnCounters[column];
+}
+
+const BitmaskType &Board::rowSkyscrapers(std::size_t row) const
+{
+    return mRowCounters[row].skyscrapers;
+}
+
+const BitmaskType &Board::columnSkyscrapers(std::size_t column) const
+{
+    return mColumnCounters[column].skyscrapers;
+}
+
+std::size_t Board::skyscraperCount() const
+{
+    return mSkyscraperCount;
+}
+
 std::vector<std::vector<int>> Board::skyscrapers2d() const
 {
     std::vector<std::vector<int>> skyscrapers2d(mSize, std::vector<int>());
 
     std::size_t j = 0;
     skyscrapers2d[j].reserve(mSize);
-    for (std::size_t i = 0; i < fields.size(); ++i) {
+    for (std::size_t i = 0; i < mFields.size(); ++i) {
         if (i != 0 && i % mSize == 0) {
             ++j;
             skyscrapers2d[j].reserve(mSize);
         }
-        skyscrapers2d[j].emplace_back(fields[i].skyscraper(mSize));
+        skyscrapers2d[j].emplace_back(mFields[i].skyscraper());
     }
     return skyscrapers2d;
 }
@@ -83,6 +255,11 @@ std::size_t Board::size() const
     return mSize;
 }
 
+LineSolverScratch &Board::lineSolverScratch()
+{
+    return mLineSolverScratch;
+}
+
 void Board::makeRows()
 {
     BorderIterator borderIterator{mSize};
@@ -94,33 +271,101 @@ void Board::makeRows()
         mRows.emplace_back(
             Row{*this, borderIterator.point(), borderIterator.readDirection()});
     }
-    connnectRowsWithCrossingRows();
 }
 
-void Board::connnectRowsWithCrossingRows()
+bool Board::isConsistent(std::size_t idx, BitmaskType removedValues) const
 {
-    std::size_t boardSize = mRows.size() / 2;
+    const auto &field = mFields[idx];
+    const auto &rowCounters = mRowCounters[idx / mSize];
+    const auto &columnCounters = mColumnCounters[idx % mSize];
 
-    std::vector<int> targetRowsIdx(boardSize);
-    std::iota(targetRowsIdx.begin(), targetRowsIdx.end(), boardSize);
-
-    for (std::size_t i = 0; i < mRows.size(); ++i) {
-        if (i == mRows.size() / 2) {
-            std::iota(targetRowsIdx.begin(), targetRowsIdx.end(), 0);
-            std::reverse(targetRowsIdx.begin(), targetRowsIdx.end());
+    if ((field.bitmask() & fullBitmask(mSize)) == BitmaskType{}) {
+        return false;
+    }
+    if (field.hasSkyscraper()) {
+        auto skyscraper = field.skyscraper();
+        if (rowCounters.skyscraperCounts[skyscraper - 1] > 1 ||
+            columnCounters.skyscraperCounts[skyscraper - 1] > 1) {
+            return false;
         }
-
-        for (const auto &targetRowIdx : targetRowsIdx) {
-            mRows[i].addCrossingRows(&mRows[targetRowIdx]);
+    }
+    for (; removedValues != BitmaskType{};
+         removedValues = clearLowestBit(removedValues)) {
+        auto value = countTrailingZeros(removedValues);
+        if (rowCounters.candidateCounts[value] == 0 ||
+            columnCounters.candidateCounts[value] == 0) {
+            return false;
         }
     }
+    return true;
+}
+
+void Board::clearEvents()
+{
+    for (auto rowIdx : mEventQueue) {
+        mRowEvents[rowIdx] = RowEvents{};
+    }
+    mEventQueue.clear();
+}
+
+void Board::queueEvents(std::size_t rowIdx, BitmaskType skyscrapers,
+                        BitmaskType removedValues)
+{
+    if (skyscrapers == BitmaskType{} && removedValues == BitmaskType{}) {
+        return;
+    }
+
+    auto &events = mRowEvents[rowIdx];
+    if (events.skyscrapers == BitmaskType{} &&
+        events.removedValues == BitmaskType{}) {
+        mEventQueue.push_back(rowIdx);
+    }
+    events.skyscrapers |= skyscrapers;
+    events.removedValues |= removedValues;
+}
+
+void Board::addSkyscraper(RowCounters &counters, int skyscraper)
+{
+    ++counters.skyscraperCount;
+    ++counters.skyscraperCounts[skyscraper - 1];
+    counters.skyscrapers |= valueBitmask(skyscraper);
+}
+
+void Board::removeSkyscraper(RowCounters &counters, int skyscraper)
+{
+    --counters.skyscraperCount;
+    if (--counters.skyscraperCounts[skyscraper - 1] == 0) {
+        counters.skyscrapers &= ~valueBitmask(skyscraper);
+    }
+}
+
+void Board::addCandidate(RowCounters &counters, int value)
+{
+    auto count = ++counters.candidateCounts[value - 1];
+    if (count == 1) {
+        counters.singleCandidates |= valueBitmask(value);
+    }
+    else if (count == 2) {
+        counters.singleCandidates &= ~valueBitmask(value);
+    }
+}
+
+void Board::removeCandidate(RowCounters &counters, int value)
+{
+    auto count = --counters.candidateCounts[value - 1];
+    if (count == 1) {
+        counters.singleCandidates |= valueBitmask(value);
+    }
+    else if (count == 0) {
+        counters.singleCandidates &= ~valueBitmask(value);
+    }
 }
 
 void debug_print(Board &board, const std::string &title)
 {
     std::cout << title << '\n';
 
-    for (std::size_t i = 0; i < board.fields.size(); ++i) {
+    for (std::size_t i = 0; i < board.fields().size(); ++i) {
 
         if (i % board.size() == 0 && i != 0) {
             std::cout << '\n';
@@ -129,21 +374,15 @@ void debug_print(Board &board, const std::string &title)
         auto elementSize = board.size() * 2;
         std::string element;
         element.reserve(elementSize);
-        if (board.fields[i].skyscraper(board.size()) != 0) {
-            element =
-                "V" + std::to_string(board.fields[i].skyscraper(board.size()));
+        if (board.fields()[i].skyscraper() != 0) {
+            element = "V" + std::to_string(board.fields()[i].skyscraper());
         }
-        else if (board.fields[i].skyscraper(board.size()) == 0 &&
-                 !board.fields[i].nopes(board.size()).empty()) {
-            auto nopes_set = board.fields[i].nopes(board.size());
-            std::vector<int> nopes(nopes_set.begin(), nopes_set.end());
-            std::sort(nopes.begin(), nopes.end());
-
-            for (std::size_t i = 0; i < nopes.size(); ++i) {
-                element.append(std::to_string(nopes[i]));
-                if (i != nopes.size() - 1) {
+        else {
+            for (const auto &nope : board.fields()[i].nopes(board.size())) {
+                if (!element.empty()) {
                     element.push_back(',');
                 }
+                element.append(std::to_string(nope));
             }
         }
         element.resize(elementSize, ' ');
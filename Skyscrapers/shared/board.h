@@ -2,24 +2,63 @@
 #define BOARD_H
 
 #include "field.h"
+#include "linesolver.h"
 #include "row.h"
+#include "rowcounters.h"
 
+#include <deque>
 #include <string>
 #include <vector>
 
-class RowClues;
-
 class Board {
 public:
+    // throws std::invalid_argument if size is bigger than maxBoardSize, the
+    // bitmasks of the fields cannot hold the values of such a board
     Board(std::size_t size);
 
-    void insert(const std::vector<RowClues> &rowClues);
+    // all functions which change fields return false if the board has a
+    // contradiction afterwards. Propagation stops at the first one
+
+    // clues around the board, 0 stands for a missing clue
+    bool insertClues(const std::vector<int> &clues);
 
-    void insert(const std::vector<std::vector<int>> &startingSkyscrapers);
+    bool insert(const std::vector<std::vector<int>> &startingSkyscrapers);
 
     bool isSolved() const;
 
-    std::vector<Field> fields;
+    // same fields stored row major and column major so every Row reads
+    // contiguous memory
+    const std::vector<Field> &fields() const;
+    const std::vector<Field> &transposedFields() const;
+
+    // every change of a field has to go through here to keep the counters
+    // of the rows and columns in sync. Queues the changes as events for the
+    // row and the column of the field
+    bool setField(std::size_t idx, const Field &field);
+
+    // handles the queued events until no row has events anymore
+    bool propagate();
+
+    // a field without any value, a skyscraper twice in a row or a value
+    // which fits into no field of a row anymore
+    bool hasContradiction() const;
+
+    // every change of setField() is recorded. rollback() undoes all changes
+    // made after checkpoint() returned mark, its cost only depends on the
+    // count of these changes. Queued events are dropped and a contradiction
+    // which came up after mark is gone
+    std::size_t checkpoint() const;
+    void rollback(std::size_t mark);
+
+    const RowCounters &rowCounters(std::size_t row) const;
+    const RowCounters &columnCounters(std::size_t column) const;
+
+    // skyscrapers already placed in a row / column as bitmask
+    const BitmaskType &rowSkyscrapers(std::size_t row) const;
+    const BitmaskType &columnSkyscrapers(std::size_t column) const;
+
+    // fields with a skyscraper on the whole board
+    std::size_t skyscraperCount() const;
 
     std::vector<Row> mRows;
 
@@ -27,9 +66,60 @@ public:
 
     std::size_t size() const;
 
+    // shared by all rows which solve themselves in propagate()
+    LineSolverScratch &lineSolverScratch();
+
 private:
     void makeRows();
-    void connnectRowsWithCrossingRows();
+
+    // changes the field and the counters without recording or queueing
+    void replaceField(std::size_t idx, const Field &field);
+
+    bool isConsistent(std::size_t idx, BitmaskType removedValues) const;
+
+    void clearEvents();
+
+    // events are collected per row so a row is only once in the queue no
+    // matter how many of its fields changed
+    struct RowEvents {
+        // fields which got a skyscraper
+        BitmaskType skyscrapers{};
+        // values which got removed from fields
+        BitmaskType removedValues{};
+    };
+
+    void queueEvents(std::size_t rowIdx, BitmaskType skyscrapers,
+                     BitmaskType removedValues);
+
+    static void addSkyscraper(RowCounters &counters, int skyscraper);
+    static void removeSkyscraper(RowCounters &counters, int skyscraper);
+    static void addCandidate(RowCounters &counters, int value);
+    static void removeCandidate(RowCounters &counters, int value);
+
+    std::vector<Field> mFields;
+    std::vector<Field> mTransposedFields;
+
+    std::vector<RowCounters> mRowCounters;
+    std::vector<RowCounters> mColumnCounters;
+    std::size_t mSkyscraperCount;
+
+    struct TrailEntry {
+        std::size_t idx;
+        Field field;
+    };
+
+    // fields before they got changed, the latest change at the back
+    std::vector<TrailEntry> mTrail;
+
+    bool mHasContradiction;
+    // trail size when the contradiction came up
+    std::size_t mContradictionMark;
+
+    // indexed like mRows
+    std::vector<RowEvents> mRowEvents;
+    std::deque<std::size_t> mEventQueue;
+
+    LineSolverScratch mLineSolverScratch;
 
     std::size_t mSize;
 };
@@ -0,0 +1,72 @@
+#include "cluebounds.h"
+
+#include <algorithm>
+
+namespace {
+
+// masks are read from the side of the clue. Removes the values which make
+// a field surely visible while the buildings visible in front of it, the
+// field itself and the taller ones behind it cannot add up to clue. How
+// many buildings are visible in front is bounded by the fields which are
+// surely visible or surely hidden with their values left
+void narrowToClueBounds(RowMasks &masks, std::size_t size, int clue)
+{
+    auto full = fullBitmask(size);
+    auto tallest = static_cast<int>(size);
+
+    // the tallest value which can be in front of the field
+    int tallestBefore = 0;
+    // one of the fields in front has at least this value
+    int surelyTallerBefore = 0;
+    int minVisibleBefore = 0;
+    int maxVisibleBefore = 0;
+
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto fieldsBehind = static_cast<int>(size - 1 - idx);
+
+        for (auto values = static_cast<BitmaskType>(masks[idx] & full);
+             values != BitmaskType{}; values = clearLowestBit(values)) {
+            auto value = countTrailingZeros(values) + 1;
+            if (value <= tallestBefore && value != tallest) {
+                continue;
+            }
+            // behind a smaller value the tallest building is visible
+            auto minVisible = minVisibleBefore + 1 + (value < tallest ? 1 : 0);
+            auto maxVisible = std::min(maxVisibleBefore, value - 1) + 1 +
+                              std::min(tallest - value, fieldsBehind);
+            if (clue < minVisible || clue > maxVisible) {
+                masks[idx] &= static_cast<BitmaskType>(~valueBitmask(value));
+            }
+        }
+
+        auto values = static_cast<BitmaskType>(masks[idx] & full);
+        if (values == BitmaskType{}) {
+            return;
+        }
+        auto lowest = countTrailingZeros(values) + 1;
+        auto highest = bitWidth(values);
+        if (lowest > tallestBefore) {
+            ++minVisibleBefore;
+        }
+        if (highest >= surelyTallerBefore) {
+            ++maxVisibleBefore;
+        }
+        tallestBefore = std::max(tallestBefore, highest);
+        surelyTallerBefore = std::max(surelyTallerBefore, lowest);
+    }
+}
+
+} // namespace
+
+void narrowToClueBounds(RowMasks &masks, std::size_t size, int front,
+                        int back)
+{
+    if (front != 0) {
+        narrowToClueBounds(masks, size, front);
+    }
+    if (back != 0) {
+        std::reverse(masks.begin(), masks.begin() + size);
+        narrowToClueBounds(masks, size, back);
+        std::reverse(masks.begin(), masks.begin() + size);
+    }
+}
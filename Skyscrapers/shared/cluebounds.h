@@ -0,0 +1,21 @@
+#ifndef CLUEBOUNDS_H
+#define CLUEBOUNDS_H
+
+#include "rowkernels.h"
+
+#include <cstddef>
+
+/*
+    Cheap rule which narrows the fields of a row with the clues before the
+    line solver runs and for rows too big for it. For each value of a field
+    the buildings visible from the clue are bounded by what is still
+    possible in front of the field and by how many taller buildings can be
+    behind it. Values which cannot reach the clue are removed.
+
+    Only removes values which are part of no permutation fitting to the
+    clues, but keeps many of them. 0 stands for a missing clue.
+*/
+void narrowToClueBounds(RowMasks &masks, std::size_t size, int front,
+                        int back);
+
+#endif
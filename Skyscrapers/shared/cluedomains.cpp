@@ -0,0 +1,132 @@
+#include "cluedomains.h"
+
+#include "linesolver.h"
+
+#include <array>
+#include <cassert>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+// what the clue alone tells about the fields from its side
+RowMasks singleClueDomains(std::size_t size, int clue)
+{
+    RowMasks domains{};
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        domains[idx] = fullBitmask(size);
+    }
+    if (clue == 0) {
+        return domains;
+    }
+
+    if (clue == static_cast<int>(size)) {
+        for (std::size_t idx = 0; idx < size; ++idx) {
+            domains[idx] = valueBitmask(static_cast<int>(idx) + 1);
+        }
+    }
+    else if (clue == 1) {
+        domains[0] = valueBitmask(static_cast<int>(size));
+    }
+    else {
+        // the first clue - 1 fields leave room for taller buildings
+        for (std::size_t idx = 0; idx < static_cast<std::size_t>(clue - 1);
+             ++idx) {
+            domains[idx] = fullBitmask(size - (clue - 1) + idx);
+        }
+        if (clue == 2) {
+            domains[1] &= ~valueBitmask(static_cast<int>(size) - 1);
+        }
+    }
+    return domains;
+}
+
+RowMasks simpleClueDomains(std::size_t size, int front, int back)
+{
+    auto domains = singleClueDomains(size, front);
+    auto backDomains = singleClueDomains(size, back);
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        domains[idx] &= backDomains[size - 1 - idx];
+    }
+    return domains;
+}
+
+RowMasks exactClueDomains(std::size_t size, int front, int back)
+{
+    RowMasks domains{};
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        domains[idx] = fullBitmask(size);
+    }
+    RowMasks supported{};
+    LineSolverScratch scratch;
+    // impossible clues leave the fields empty
+    solveLine(size, front, back, domains, supported, scratch);
+    return supported;
+}
+
+class ClueDomainTable {
+public:
+    explicit ClueDomainTable(std::size_t size)
+        : mSize{size}, mSlots{new Slot[(size + 1) * (size + 1)]}
+    {
+    }
+
+    const RowMasks &domains(int front, int back) const
+    {
+        auto &slot = mSlots[front * (mSize + 1) + back];
+        std::call_once(slot.made, [&] {
+            if (mSize > maxLineSolverSize) {
+                slot.domains = simpleClueDomains(mSize, front, back);
+            }
+            else if (front > back) {
+                const auto &mirrored = domains(back, front);
+                for (std::size_t idx = 0; idx < mSize; ++idx) {
+                    slot.domains[idx] = mirrored[mSize - 1 - idx];
+                }
+            }
+            else {
+                slot.domains = exactClueDomains(mSize, front, back);
+            }
+        });
+        return slot.domains;
+    }
+
+private:
+    struct Slot {
+        std::once_flag made;
+        RowMasks domains{};
+    };
+
+    std::size_t mSize;
+    // at front * (size + 1) + back
+    std::unique_ptr<Slot[]> mSlots;
+};
+
+} // namespace
+
+const RowMasks &clueDomains(std::size_t size, int front, int back)
+{
+    assert(size > 0 && size <= maxBoardSize);
+    assert(front >= 0 && front <= static_cast<int>(size));
+    assert(back >= 0 && back <= static_cast<int>(size));
+
+    static std::array<std::once_flag, maxBoardSize + 1> created;
+    static std::array<std::unique_ptr<ClueDomainTable>, maxBoardSize + 1>
+        tables;
+
+    std::call_once(created[size], [size] {
+        tables[size] = std::make_unique<ClueDomainTable>(size);
+    });
+    return tables[size]->domains(front, back);
+}
+
+std::size_t backClueIdx(std::size_t rowIdx, std::size_t size)
+{
+    assert(rowIdx < 2 * size);
+
+    // the clues go clockwise around the board starting top left
+    if (rowIdx < size) {
+        return 3 * size - 1 - rowIdx;
+    }
+    return 5 * size - 1 - rowIdx;
+}
@@ -0,0 +1,23 @@
+#ifndef CLUEDOMAINS_H
+#define CLUEDOMAINS_H
+
+#include "rowkernels.h"
+
+#include <cstddef>
+
+/*
+    The values every field of a row can have with the clues front and back,
+    exactly the values of all permutations which fit to the clues. 0 stands
+    for a missing clue.
+
+    A table is made once per size and clue pair on first use and shared by
+    all boards and threads afterwards. Rows bigger than maxLineSolverSize
+    only get the values left by simple rules per clue.
+*/
+const RowMasks &clueDomains(std::size_t size, int front, int back);
+
+// index of the back clue of the row at rowIdx in Board::mRows out of the
+// clues around the board. The front clue is at rowIdx
+std::size_t backClueIdx(std::size_t rowIdx, std::size_t size);
+
+#endif
@@ -2,14 +2,68 @@
 
 #include <cassert>
 
+FieldValues::Iterator::Iterator(BitmaskType bitmask) : mBitmask{bitmask}
+{
+}
+
+int FieldValues::Iterator::operator*() const
+{
+    assert(mBitmask != BitmaskType{});
+    return countTrailingZeros(mBitmask) + 1;
+}
+
+FieldValues::Iterator &FieldValues::Iterator::operator++()
+{
+    mBitmask = clearLowestBit(mBitmask);
+    return *this;
+}
+
+bool FieldValues::Iterator::operator==(const Iterator &other) const
+{
+    return mBitmask == other.mBitmask;
+}
+
+bool FieldValues::Iterator::operator!=(const Iterator &other) const
+{
+    return !(*this == other);
+}
+
+FieldValues::FieldValues(BitmaskType bitmask) : mBitmask{bitmask}
+{
+}
+
+FieldValues::Iterator FieldValues::begin() const
+{
+    return Iterator{mBitmask};
+}
+
+FieldValues::Iterator FieldValues::end() const
+{
+    return Iterator{0};
+}
+
+bool FieldValues::empty() const
+{
+    return mBitmask == BitmaskType{};
+}
+
+int FieldValues::size() const
+{
+    return popCount(mBitmask);
+}
+
+Field::Field(BitmaskType bitmask) : mBitmask{bitmask}
+{
+}
+
 void Field::insertSkyscraper(int skyscraper)
 {
-    mBitmask = 1 << (skyscraper - 1);
+    mBitmask = valueBitmask(skyscraper);
 }
 
 void Field::insertNope(int nope)
 {
-    mBitmask &= ~(1 << (nope - 1));
+    mBitmask &= ~valueBitmask(nope);
 }
 
 void Field::insertNopes(const std::vector<int> &nopes)
@@ -24,31 +78,29 @@ void Field::insertNopes(const Field &field)
     mBitmask &= field.mBitmask;
 }
 
-int Field::skyscraper(std::size_t size) const
+int Field::skyscraper() const
 {
     if (!hasSkyscraper()) {
         return 0;
     }
+    return countTrailingZeros(mBitmask) + 1;
+}
 
-    for (std::size_t i = 0; i < size; ++i) {
-        if (bitIsToggled(mBitmask, i)) {
-            return i + 1;
-        }
-    }
-    assert(false);
-    return 0;
+FieldValues Field::nopes(std::size_t size) const
+{
+    return FieldValues{
+        static_cast<BitmaskType>(~mBitmask & fullBitmask(size))};
 }
 
-std::vector<int> Field::nopes(std::size_t size) const
+FieldValues Field::candidates(std::size_t size) const
 {
-    std::vector<int> nopes;
-    nopes.reserve(size - 1);
-    for (std::size_t i = 0; i < size; ++i) {
-        if (!bitIsToggled(mBitmask, i)) {
-            nopes.emplace_back(i + 1);
-        }
-    }
-    return nopes;
+    return FieldValues{
+        static_cast<BitmaskType>(mBitmask & fullBitmask(size))};
+}
+
+int Field::candidateCount(std::size_t size) const
+{
+    return popCount(mBitmask & fullBitmask(size));
 }
 
 bool Field::hasSkyscraper() const
@@ -56,9 +108,14 @@ bool Field::hasSkyscraper() const
     return hasSingleBit(mBitmask);
 }
 
+BitmaskType Field::bitmask() const
+{
+    return mBitmask;
+}
+
 bool Field::containsNope(int value) const
 {
-    return !bitIsToggled(mBitmask, value - 1);
+    return (mBitmask & valueBitmask(value)) == BitmaskType{};
 }
 
 bool Field::containsNopes(const std::vector<int> &values) const
@@ -70,13 +127,3 @@ bool Field::containsNopes(const std::vector<int> &values) const
     }
     return true;
 }
-
-bool Field::bitIsToggled(BitmaskType bitmask, int bit) const
-{
-    return bitmask & (1 << bit);
-}
-
-bool Field::hasSingleBit(BitmaskType bitmask) const
-{
-    return bitmask != 0 && (bitmask & (bitmask - 1)) == 0;
-}
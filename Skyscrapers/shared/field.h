@@ -1,10 +1,10 @@
 #ifndef FIELD_H
 #define FIELD_H
 
-#include <cstdint>
-#include <vector>
+#include "bitmask.h"
 
-using BitmaskType = std::uint32_t;
+#include <iterator>
+#include <vector>
 
 /*
     Example size = 4
@@ -27,29 +27,67 @@ using BitmaskType = std::uint32_t;
     b1111 15 Nopes = {}
 */
 
+// Allocation free view over the values (bit index + 1) of all toggled bits in
+// a bitmask. Iterating costs one count trailing zeros per value.
+class FieldValues {
+public:
+    class Iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = int;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const int *;
+        using reference = int;
+
+        explicit Iterator(BitmaskType bitmask);
+
+        int operator*() const;
+        Iterator &operator++();
+
+        bool operator==(const Iterator &other) const;
+        bool operator!=(const Iterator &other) const;
+
+    private:
+        BitmaskType mBitmask;
+    };
+
+    explicit FieldValues(BitmaskType bitmask);
+
+    Iterator begin() const;
+    Iterator end() const;
+
+    bool empty() const;
+    int size() const;
+
+private:
+    BitmaskType mBitmask;
+};
+
 class Field {
 public:
     Field() = default;
+    explicit Field(BitmaskType bitmask);
 
     void insertSkyscraper(int skyscraper);
     void insertNope(int nope);
     void insertNopes(const std::vector<int> &nopes);
     void insertNopes(const Field &field);
 
-    int skyscraper(std::size_t size) const;
-    std::vector<int> nopes(std::size_t size) const;
+    int skyscraper() const;
+    FieldValues nopes(std::size_t size) const;
+    FieldValues candidates(std::size_t size) const;
+    int candidateCount(std::size_t size) const;
 
     bool hasSkyscraper() const;
 
+    // toggled bit for every value which is still possible
+    BitmaskType bitmask() const;
+
     bool containsNope(int value) const;
     bool containsNopes(const std::vector<int> &values) const;
 
 private:
-    bool bitIsToggled(BitmaskType bitmask, int bit) const;
-    // same as c++20 std::has_single_bit()
-    bool hasSingleBit(BitmaskType bitmask) const;
-
-    BitmaskType mBitmask{static_cast<BitmaskType>(-1)};
+    BitmaskType mBitmask{fullBitmask(maxBoardSize)};
 
     friend inline bool operator==(const Field &lhs, const Field &rhs);
     friend inline bool operator!=(const Field &lhs, const Field &rhs);
@@ -0,0 +1,86 @@
+#include "layeredstates.h"
+
+#include "visibility.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace {
+
+using State = LayeredStates::State;
+using Edge = LayeredStates::Edge;
+
+std::uint64_t stateKey(const State &state)
+{
+    return state.usedValues |
+           static_cast<std::uint64_t>(state.frontVisible) << 48 |
+           static_cast<std::uint64_t>(state.backVisible) << 56;
+}
+
+} // namespace
+
+bool buildLayeredStates(std::size_t size, int front, int back,
+                        const RowMasks &domains, LayeredStates &layers)
+{
+    // the key keeps 48 bits for the used values
+    assert(size > 0 && size <= 48 && size <= rowLanes);
+
+    auto full = fullBitmask<std::uint64_t>(size);
+
+    auto &states = layers.states;
+    auto &edges = layers.edges;
+    states.clear();
+    edges.clear();
+    layers.layerBegin.assign(1, 0);
+    layers.edgeBegin.assign(1, 0);
+    states.push_back(State{0, 0, 0});
+
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        auto begin = layers.layerBegin[idx];
+        auto end = static_cast<std::uint32_t>(states.size());
+        layers.layerBegin.push_back(end);
+        layers.nextStates.clear();
+
+        for (auto from = begin; from < end; ++from) {
+            auto state = states[from];
+            auto unusedValues = full & ~state.usedValues;
+            auto tallest = bitWidth(state.usedValues);
+            auto tallestUnused = bitWidth(unusedValues);
+
+            for (auto values = lowBits(domains[idx]) & unusedValues;
+                 values != 0; values = clearLowestBit(values)) {
+                auto value = countTrailingZeros(values) + 1;
+
+                auto next = state;
+                next.usedValues |= valueBitmask<std::uint64_t>(value);
+                // a missing clue does not need to be counted which merges
+                // more states
+                if (front != 0 && value > tallest) {
+                    ++next.frontVisible;
+                }
+                if (back != 0 && value == tallestUnused) {
+                    ++next.backVisible;
+                }
+                if (!cluesReachable(front, back, full & ~next.usedValues,
+                                    std::max(tallest, value),
+                                    next.frontVisible, next.backVisible)) {
+                    continue;
+                }
+
+                auto [it, inserted] = layers.nextStates.emplace(
+                    stateKey(next), static_cast<std::uint32_t>(states.size()));
+                if (inserted) {
+                    states.push_back(next);
+                }
+                edges.push_back(Edge{from, it->second, value});
+            }
+        }
+        layers.edgeBegin.push_back(static_cast<std::uint32_t>(edges.size()));
+
+        if (states.size() == end) {
+            return false;
+        }
+    }
+    layers.layerBegin.push_back(static_cast<std::uint32_t>(states.size()));
+    return true;
+}
@@ -0,0 +1,50 @@
+#ifndef LAYEREDSTATES_H
+#define LAYEREDSTATES_H
+
+#include "rowkernels.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/*
+    The permutations of a row which fit to a clue pair as paths through
+    layers of states. A state holds the values placed so far and the
+    buildings visible from the front and the back, layer idx holds the
+    states after idx fields. Only states from which the clues can still be
+    reached are kept and each state exists once per layer, so the work grows
+    with the count of states instead of the count of permutations.
+
+    The count of states grows with 2^size.
+*/
+struct LayeredStates {
+    struct State {
+        std::uint64_t usedValues;
+        int frontVisible;
+        int backVisible;
+    };
+    // value placed on the way from a state to a state in the next layer
+    struct Edge {
+        std::uint32_t from;
+        std::uint32_t to;
+        int value;
+    };
+
+    // the states of field idx start at layerBegin[idx]
+    std::vector<State> states;
+    std::vector<std::uint32_t> layerBegin;
+    // the edges from the states of field idx start at edgeBegin[idx], they
+    // are ordered by from
+    std::vector<Edge> edges;
+    std::vector<std::uint32_t> edgeBegin;
+    std::unordered_map<std::uint64_t, std::uint32_t> nextStates;
+};
+
+// builds the states of permutations of distinct values out of domains,
+// replaces the content of layers. 0 stands for a missing clue. Returns
+// false and stops as soon as a layer stays empty
+bool buildLayeredStates(std::size_t size, int front, int back,
+                        const RowMasks &domains, LayeredStates &layers);
+
+#endif
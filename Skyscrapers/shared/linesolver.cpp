@@ -0,0 +1,34 @@
+#include "linesolver.h"
+
+#include <algorithm>
+#include <cassert>
+
+bool solveLine(std::size_t size, int front, int back, const RowMasks &domains,
+               RowMasks &supported, LineSolverScratch &scratch)
+{
+    assert(size > 0 && size <= maxLineSolverSize);
+
+    supported = RowMasks{};
+    auto &layers = scratch.layers;
+    if (!buildLayeredStates(size, front, back, domains, layers)) {
+        return false;
+    }
+
+    // all states of the last layer fit to the clues, walk back from them
+    const auto &edges = layers.edges;
+    auto &reachesEnd = scratch.reachesEnd;
+    reachesEnd.assign(layers.states.size(), 0);
+    std::fill(reachesEnd.begin() + layers.layerBegin[size], reachesEnd.end(),
+              1);
+
+    for (auto idx = size; idx-- > 0;) {
+        for (auto edge = layers.edgeBegin[idx];
+             edge < layers.edgeBegin[idx + 1]; ++edge) {
+            if (reachesEnd[edges[edge].to]) {
+                reachesEnd[edges[edge].from] = 1;
+                supported[idx] |= valueBitmask(edges[edge].value);
+            }
+        }
+    }
+    return true;
+}
@@ -0,0 +1,32 @@
+#ifndef LINESOLVER_H
+#define LINESOLVER_H
+
+#include "layeredstates.h"
+#include "rowkernels.h"
+
+#include <cstddef>
+#include <vector>
+
+/*
+    Solves a row on its own. The permutations which fit to the clues are
+    build up as layered states, a backward pass keeps the values which lie
+    on a path through the whole row.
+
+    The count of states grows with 2^size, bigger rows are not solved.
+*/
+
+constexpr std::size_t maxLineSolverSize = 16;
+
+// buffers of solveLine() kept between calls to not allocate every time
+struct LineSolverScratch {
+    LayeredStates layers;
+    std::vector<char> reachesEnd;
+};
+
+// supported are the values on every field which are part of at least one
+// permutation of distinct values out of domains which fits to the clues.
+// 0 stands for a missing clue. Returns false if there is no permutation
+bool solveLine(std::size_t size, int front, int back, const RowMasks &domains,
+               RowMasks &supported, LineSolverScratch &scratch);
+
+#endif
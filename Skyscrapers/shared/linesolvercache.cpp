@@ -0,0 +1,97 @@
+#include "linesolvercache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+
+namespace {
+
+std::uint64_t mix(std::uint64_t hash, std::uint64_t value)
+{
+    hash ^= value + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+} // namespace
+
+LineSolverCache &LineSolverCache::forThisThread()
+{
+    static thread_local LineSolverCache cache;
+    return cache;
+}
+
+LineSolverCache::LineSolverCache(std::size_t slotCount) : mSlots(slotCount)
+{
+    assert(slotCount > 0);
+}
+
+bool LineSolverCache::solve(std::size_t size, int front, int back,
+                            const RowMasks &domains, RowMasks &supported,
+                            LineSolverScratch &scratch)
+{
+    assert(size <= maxLineSolverSize);
+
+    // only the values up to size belong to the state
+    auto full = fullBitmask(size);
+    RowMasks state{};
+    auto hash = mix(mix(size, static_cast<std::uint64_t>(front)),
+                    static_cast<std::uint64_t>(back));
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        state[idx] = static_cast<BitmaskType>(domains[idx] & full);
+        hash = mix(hash, lowBits(state[idx]));
+    }
+
+    auto &slot = mSlots[hash % mSlots.size()];
+    if (slot.used && slot.hash == hash && slot.size == size &&
+        slot.front == front && slot.back == back && slot.domains == state) {
+        ++mHits;
+        supported = slot.supported;
+        return slot.solvable;
+    }
+    ++mMisses;
+
+    auto solvable = solveLine(size, front, back, state, supported, scratch);
+
+    slot.hash = hash;
+    slot.used = true;
+    slot.solvable = solvable;
+    slot.size = static_cast<std::uint8_t>(size);
+    slot.front = static_cast<std::int8_t>(front);
+    slot.back = static_cast<std::int8_t>(back);
+    slot.domains = state;
+    slot.supported = supported;
+    return solvable;
+}
+
+std::uint64_t LineSolverCache::hits() const
+{
+    return mHits;
+}
+
+std::uint64_t LineSolverCache::misses() const
+{
+    return mMisses;
+}
+
+double LineSolverCache::hitRate() const
+{
+    auto lookups = mHits + mMisses;
+    if (lookups == 0) {
+        return 0.0;
+    }
+    return static_cast<double>(mHits) / static_cast<double>(lookups);
+}
+
+void LineSolverCache::clear()
+{
+    std::fill(mSlots.begin(), mSlots.end(), Slot{});
+    mHits = 0;
+    mMisses = 0;
+}
+
+void debug_print(const LineSolverCache &cache, const std::string &title)
+{
+    std::cout << title << '\n';
+    std::cout << "hits:" << cache.hits() << " misses:" << cache.misses()
+              << " hit rate:" << cache.hitRate() << '\n';
+}
@@ -0,0 +1,61 @@
+#ifndef LINESOLVERCACHE_H
+#define LINESOLVERCACHE_H
+
+#include "linesolver.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+    Remembers what solveLine() returned for a row state. The same fields
+    of a row with the same clues come up again and again while rows are
+    propagated, while a search goes back and forth and across boards of
+    the same size.
+
+    The state is hashed into a table of fixed size and a new state simply
+    replaces the one which was in its slot. There is one cache per thread
+    so boards on different threads do not need to lock.
+*/
+class LineSolverCache {
+public:
+    static LineSolverCache &forThisThread();
+
+    explicit LineSolverCache(std::size_t slotCount = defaultSlotCount);
+
+    // same as solveLine() but a row state which is still in the cache is
+    // not solved again
+    bool solve(std::size_t size, int front, int back, const RowMasks &domains,
+               RowMasks &supported, LineSolverScratch &scratch);
+
+    std::uint64_t hits() const;
+    std::uint64_t misses() const;
+    // hits out of all lookups, 0 if there was none
+    double hitRate() const;
+
+    void clear();
+
+    static constexpr std::size_t defaultSlotCount = 1 << 14;
+
+private:
+    struct Slot {
+        std::uint64_t hash{0};
+        bool used{false};
+        bool solvable{false};
+        std::uint8_t size{0};
+        std::int8_t front{0};
+        std::int8_t back{0};
+        RowMasks domains{};
+        RowMasks supported{};
+    };
+
+    std::vector<Slot> mSlots;
+    std::uint64_t mHits{0};
+    std::uint64_t mMisses{0};
+};
+
+// hits, misses and hit rate
+void debug_print(const LineSolverCache &cache, const std::string &title = "");
+
+#endif
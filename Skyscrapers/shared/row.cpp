@@ -2,25 +2,36 @@
 
 #include "board.h"
 #include "borderiterator.h"
+#include "cluebounds.h"
 #include "field.h"
-#include "missingnumberinsequence.h"
+#include "linesolvercache.h"
 #include "point.h"
+#include "rowcounters.h"
 
 #include <algorithm>
 #include <cassert>
-#include <unordered_map>
 
 Row::Row(Board &board, const Point &startPoint,
          const ReadDirection &readDirection)
     : mBoard{board}, mStartPoint{startPoint}, mReadDirection{readDirection}
 {
-}
+    std::size_t size = mBoard.size();
 
-void Row::addCrossingRows(Row *crossingRow)
-{
-    assert(crossingRow != nullptr);
-    assert(mCrossingRows.size() < mBoard.size());
-    mCrossingRows.push_back(crossingRow);
+    if (mReadDirection == ReadDirection::topToBottom) {
+        mFirstBoardIdx = mStartPoint.x + mStartPoint.y * size;
+        mBoardIdxStep = size;
+        mFirstField =
+            &mBoard.transposedFields()[mStartPoint.x * size + mStartPoint.y];
+        mFieldStep = 1;
+        mCounters = &mBoard.columnCounters(mStartPoint.x);
+    }
+    else {
+        mFirstBoardIdx = mStartPoint.x + mStartPoint.y * size;
+        mBoardIdxStep = -1;
+        mFirstField = &mBoard.fields()[mFirstBoardIdx];
+        mFieldStep = -1;
+        mCounters = &mBoard.rowCounters(mStartPoint.y);
+    }
 }
 
 bool Row::hasOnlyOneNopeField() const
@@ -28,47 +39,40 @@ bool Row::hasOnlyOneNopeField() const
     return skyscraperCount() == static_cast<int>(mBoard.size() - 1);
 }
 
-void Row::addLastMissingSkyscraper()
+bool Row::addLastMissingSkyscraper()
 {
     assert(hasOnlyOneNopeField());
 
-    std::vector<int> sequence;
-    sequence.reserve(mBoard.size() - 1);
+    auto missingValues = static_cast<BitmaskType>(
+        ~placedSkyscrapers() & fullBitmask(mBoard.size()));
+    assert(hasSingleBit(missingValues));
+    auto missingValue = countTrailingZeros(missingValues) + 1;
 
-    std::size_t nopeFieldIdx = -1;
     for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
-        if (getFieldRef(idx).hasSkyscraper()) {
-            sequence.emplace_back((getFieldRef(idx)).skyscraper(mBoard.size()));
-        }
-        else {
-            nopeFieldIdx = idx;
+        if (!getFieldRef(idx).hasSkyscraper()) {
+            if (!insertSkyscraper(idx, missingValue)) {
+                return false;
+            }
+            break;
         }
     }
-
-    assert(nopeFieldIdx != -1);
-    assert(skyscraperCount() == static_cast<int>(sequence.size()));
-
-    auto missingValue =
-        missingNumberInSequence(sequence.begin(), sequence.end());
-
-    assert(missingValue >= 0 &&
-           missingValue <= static_cast<int>(mBoard.size()));
-
-    (getFieldRef(nopeFieldIdx)).insertSkyscraper(missingValue);
-    insertSkyscraperNeighbourHandling(nopeFieldIdx, missingValue);
+    return mBoard.propagate();
 }
 
-void Row::addNopesToAllNopeFields(int nope)
+bool Row::addSkyscraper(std::size_t idx, int skyscraper)
 {
-    for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
-        if (getFieldRef(idx).hasSkyscraper()) {
-            continue;
-        }
+    if (!insertSkyscraper(idx, skyscraper)) {
+        return false;
+    }
+    return mBoard.propagate();
+}
 
-        bool hasSkyscraperBefore = false;
-        getFieldRef(idx).insertNope(nope);
-        insertNopesNeighbourHandling(idx, nope, hasSkyscraperBefore);
+bool Row::addNopesToAllNopeFields(int nope)
+{
+    if (!addNopesToAllNopeFields(valueBitmask(nope))) {
+        return false;
     }
+    return mBoard.propagate();
 }
 
 bool Row::allFieldsContainSkyscraper() const
@@ -78,39 +82,28 @@ bool Row::allFieldsContainSkyscraper() const
 
 int Row::skyscraperCount() const
 {
-    int count = 0;
+    return mCounters->skyscraperCount;
+}
 
-    for (std::size_t i = 0; i < mBoard.size(); ++i) {
-        if (getFieldRef(i).hasSkyscraper()) {
-            ++count;
-        }
-    }
-    return count;
+std::uint64_t Row::epoch() const
+{
+    return mCounters->epoch;
 }
 
 int Row::nopeCount(int nope) const
 {
-    int count = 0;
-    for (std::size_t i = 0; i < mBoard.size(); ++i) {
-        if (getFieldRef(i).hasSkyscraper()) {
-            continue;
-        }
-        if (getFieldRef(i).containsNope(nope)) {
-            ++count;
-        }
-    }
-    return count;
+    auto nopeFields = static_cast<int>(mBoard.size()) - skyscraperCount();
+    auto nopeFieldsWithValue = mCounters->candidateCounts[nope - 1] -
+                               mCounters->skyscraperCounts[nope - 1];
+    return nopeFields - nopeFieldsWithValue;
 }
 
-void Row::guessSkyscraperOutOfNeighbourNopes()
+bool Row::guessSkyscraperOutOfNeighbourNopes()
 {
-    for (;;) {
-        auto optNope = nopeValueInAllButOneField();
-        if (!optNope) {
-            break;
-        }
-        insertSkyscraperToFirstFieldWithoutNope(*optNope);
+    if (!insertSkyscrapersWithOnlyOneField(fullBitmask(mBoard.size()))) {
+        return false;
     }
+    return mBoard.propagate();
 }
 
 bool Row::hasSkyscrapers(const std::vector<int> &skyscrapers,
@@ -131,14 +124,47 @@ bool Row::hasNopes(const std::vector<std::vector<int>> &nopes,
     return hasNopes(nopes.crbegin(), nopes.crend());
 }
 
-void Row::addFieldData(const std::vector<Field> &fieldData, Direction direction)
+bool Row::addFieldData(const std::vector<Field> &fieldData, Direction direction)
 {
+    bool consistent = false;
     if (direction == Direction::front) {
-        addFieldData(fieldData.begin(), fieldData.end());
+        consistent = addFieldData(fieldData.begin(), fieldData.end());
     }
     else {
-        addFieldData(fieldData.rbegin(), fieldData.rend());
+        consistent = addFieldData(fieldData.rbegin(), fieldData.rend());
+    }
+    if (!consistent) {
+        return false;
+    }
+    return mBoard.propagate();
+}
+
+bool Row::addFieldData(const RowMasks &fieldData)
+{
+    auto outside = static_cast<BitmaskType>(~fullBitmask(mBoard.size()));
+
+    auto masks = fieldData;
+    for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
+        masks[idx] |= outside;
     }
+    if (!insertFieldData(masks)) {
+        return false;
+    }
+    return mBoard.propagate();
+}
+
+bool Row::propagate(BitmaskType skyscrapers, BitmaskType removedValues)
+{
+    if (skyscrapers != BitmaskType{}) {
+        if (!addNopesToAllNopeFields(skyscrapers)) {
+            return false;
+        }
+    }
+    if (!insertSkyscrapersWithOnlyOneField(removedValues) ||
+        !insertClueBounds()) {
+        return false;
+    }
+    return insertLineSolution();
 }
 
 template <typename SkyIterator>
@@ -149,7 +175,7 @@ bool Row::hasSkyscrapers(SkyIterator skyItBegin, SkyIterator skyItEnd) const
         if (*skyIt == 0 && getFieldRef(idx).hasSkyscraper()) {
             continue;
         }
-        if (getFieldRef(idx).skyscraper(mBoard.size()) != *skyIt) {
+        if (getFieldRef(idx).skyscraper() != *skyIt) {
             return false;
         }
     }
@@ -175,161 +201,154 @@ bool Row::hasNopes(NopesIterator nopesItBegin, NopesIterator nopesItEnd) const
 }
 
 template <typename FieldDataIterator>
-void Row::addFieldData(FieldDataIterator fieldDataItBegin,
+bool Row::addFieldData(FieldDataIterator fieldDataItBegin,
                        FieldDataIterator fieldDataItEnd)
 {
+    RowMasks fieldData;
+    fieldData.fill(Field{}.bitmask());
+
     for (auto fieldDataIt = fieldDataItBegin; fieldDataIt != fieldDataItEnd;
          ++fieldDataIt) {
 
         auto idx = std::distance(fieldDataItBegin, fieldDataIt);
-        insertFieldData(idx, *fieldDataIt);
+        fieldData[idx] = fieldDataIt->bitmask();
     }
+    return insertFieldData(fieldData);
 }
 
 const Field &Row::getFieldRef(std::size_t idx) const
 {
     assert(idx >= 0 && idx < mBoard.size());
+    return *(mFirstField + static_cast<std::ptrdiff_t>(idx) * mFieldStep);
+}
 
-    if (mReadDirection == ReadDirection::topToBottom) {
-        return mBoard
-            .fields[mStartPoint.x + (mStartPoint.y + idx) * mBoard.size()];
+bool Row::insertFieldData(RowMasks fieldData)
+{
+    auto masks = fieldMasks();
+    auto changedLanes = intersectMasks(masks, fieldData, mBoard.size());
+
+    for (auto lanes = changedLanes; lanes != BitmaskType{};
+         lanes = clearLowestBit(lanes)) {
+        std::size_t idx = countTrailingZeros(lanes);
+        if (!setField(idx, Field{masks[idx]})) {
+            return false;
+        }
     }
-    return mBoard.fields[mStartPoint.x - idx + (mStartPoint.y) * mBoard.size()];
+    return true;
 }
 
-void Row::insertFieldData(std::size_t idx, const Field &fieldData)
+bool Row::addNopesToAllNopeFields(BitmaskType nopes)
 {
-    if (fieldData.hasSkyscraper()) {
-        if (getFieldRef(idx).hasSkyscraper()) {
-            return;
+    auto size = mBoard.size();
+    auto skyscraperLanes = singleBitLanes(fieldMasks(), size);
+
+    RowMasks fieldData;
+    fieldData.fill(static_cast<BitmaskType>(~nopes));
+    // with a WideBitmask the compiler cannot bound countTrailingZeros()
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        if ((skyscraperLanes & laneBitmask(idx)) != BitmaskType{}) {
+            fieldData[idx] = Field{}.bitmask();
         }
-        getFieldRef(idx) = fieldData;
-        insertSkyscraperNeighbourHandling(
-            idx, getFieldRef(idx).skyscraper(mBoard.size()));
     }
-    else {
-        bool hasSkyscraperBefore = getFieldRef(idx).hasSkyscraper();
-        getFieldRef(idx).insertNopes(fieldData);
+    return insertFieldData(fieldData);
+}
 
-        auto nopes = fieldData.nopes(mBoard.size());
+bool Row::insertSkyscrapersWithOnlyOneField(BitmaskType values)
+{
+    for (;;) {
+        auto onlyOneField = static_cast<BitmaskType>(
+            values & mCounters->singleCandidates & ~placedSkyscrapers());
+        if (onlyOneField == BitmaskType{}) {
+            return true;
+        }
+        auto value = countTrailingZeros(onlyOneField) + 1;
 
-        for (const auto &nope : nopes) {
-            insertNopesNeighbourHandling(idx, nope, hasSkyscraperBefore);
+        for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
+            if (!getFieldRef(idx).containsNope(value)) {
+                if (!insertSkyscraper(idx, value)) {
+                    return false;
+                }
+                break;
+            }
         }
     }
 }
 
-void Row::insertSkyscraperNeighbourHandling(std::size_t idx, int skyscraper)
+bool Row::insertClueBounds()
 {
-    if (hasOnlyOneNopeField()) {
-        addLastMissingSkyscraper();
-    }
-    addNopesToAllNopeFields(skyscraper);
-
-    if (mCrossingRows[idx]->hasOnlyOneNopeField()) {
-        mCrossingRows[idx]->addLastMissingSkyscraper();
+    if (mFrontClue == 0 && mBackClue == 0) {
+        return true;
     }
-
-    mCrossingRows[idx]->addNopesToAllNopeFields(skyscraper);
+    auto masks = fieldMasks();
+    narrowToClueBounds(masks, mBoard.size(), mFrontClue, mBackClue);
+    return insertFieldData(masks);
 }
 
-void Row::insertNopesNeighbourHandling(std::size_t idx, int nope,
-                                       bool hadSkyscraperBefore)
+bool Row::insertLineSolution()
 {
-    // skyscraper was added so we have to add nopes to the neighbours
-    if (!hadSkyscraperBefore && getFieldRef(idx).hasSkyscraper()) {
-
-        insertSkyscraperNeighbourHandling(
-            idx, getFieldRef(idx).skyscraper(mBoard.size()));
+    auto size = mBoard.size();
+    if ((mFrontClue == 0 && mBackClue == 0) || size > maxLineSolverSize ||
+        mLineSolvedEpoch == epoch()) {
+        return true;
     }
 
-    if (onlyOneFieldWithoutNope(nope)) {
-        insertSkyscraperToFirstFieldWithoutNope(nope);
-    }
+    RowMasks supported;
+    auto solvable = LineSolverCache::forThisThread().solve(
+        size, mFrontClue, mBackClue, fieldMasks(), supported,
+        mBoard.lineSolverScratch());
 
-    if (mCrossingRows[idx]->onlyOneFieldWithoutNope(nope)) {
-        mCrossingRows[idx]->insertSkyscraperToFirstFieldWithoutNope(nope);
+    auto outside = static_cast<BitmaskType>(~fullBitmask(size));
+    for (std::size_t idx = 0; idx < size; ++idx) {
+        supported[idx] |= outside;
     }
-}
-
-bool Row::onlyOneFieldWithoutNope(int nope) const
-{
-    if (nopeExistsAsSkyscraperInFields(nope)) {
+    if (!solvable) {
+        // no permutation fits anymore, the empty fields are the contradiction
+        insertFieldData(supported);
         return false;
     }
-    if (nopeCount(nope) <
-        static_cast<int>(mBoard.size()) - skyscraperCount() - 1) {
+    if (!insertFieldData(supported)) {
         return false;
     }
+    // the solution of the narrowed fields is the same
+    mLineSolvedEpoch = epoch();
     return true;
 }
 
-bool Row::nopeExistsAsSkyscraperInFields(int nope) const
+BitmaskType Row::placedSkyscrapers() const
 {
-    for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
-        if (getFieldRef(idx).skyscraper(mBoard.size()) == nope) {
-            return true;
-        }
-    }
-    return false;
+    return mCounters->skyscrapers;
 }
 
-std::optional<int> Row::nopeValueInAllButOneField() const
+RowMasks Row::fieldMasks() const
 {
-    std::unordered_map<int, int> nopeAndCount;
-
-    for (std::size_t i = 0; i < mBoard.size(); ++i) {
-        if (!getFieldRef(i).hasSkyscraper()) {
-            auto nopes = getFieldRef(i).nopes(mBoard.size());
-            for (const auto &nope : nopes) {
-                if (hasSkyscraper(nope)) {
-                    continue;
-                }
-                ++nopeAndCount[nope];
-            }
-        }
-    }
-
-    for (auto cit = nopeAndCount.cbegin(); cit != nopeAndCount.end(); ++cit) {
-        if (cit->second ==
-            static_cast<int>(mBoard.size()) - skyscraperCount() - 1) {
-            return {cit->first};
-        }
+    RowMasks masks{};
+    for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
+        masks[idx] = getFieldRef(idx).bitmask();
     }
-    return {};
+    return masks;
 }
 
-void Row::insertSkyscraperToFirstFieldWithoutNope(int nope)
+void Row::setClues(int front, int back)
 {
-    for (std::size_t idx = 0; idx < mBoard.size(); ++idx) {
-        if ((getFieldRef(idx)).hasSkyscraper()) {
-            continue;
-        }
-        if (!(getFieldRef(idx)).containsNope(nope)) {
-            (getFieldRef(idx).insertSkyscraper(nope));
-            insertSkyscraperNeighbourHandling(idx, nope);
-            return; // there can be max one skyscraper per row;
-        }
-    }
+    mFrontClue = front;
+    mBackClue = back;
+    mLineSolvedEpoch = std::numeric_limits<std::uint64_t>::max();
 }
 
-bool Row::hasSkyscraper(int skyscraper) const
+std::size_t Row::boardIdx(std::size_t idx) const
 {
-    for (std::size_t i = 0; i < mBoard.size(); ++i) {
-        if (getFieldRef(i).skyscraper(mBoard.size()) == skyscraper) {
-            return true;
-        }
-    }
-    return false;
+    assert(idx >= 0 && idx < mBoard.size());
+    return mFirstBoardIdx + static_cast<std::ptrdiff_t>(idx) * mBoardIdxStep;
 }
 
-Field &Row::getFieldRef(std::size_t idx)
+bool Row::setField(std::size_t idx, const Field &field)
 {
-    assert(idx >= 0 && idx < mBoard.size());
+    return mBoard.setField(boardIdx(idx), field);
+}
 
-    if (mReadDirection == ReadDirection::topToBottom) {
-        return mBoard
-            .fields[mStartPoint.x + (mStartPoint.y + idx) * mBoard.size()];
-    }
-    return mBoard.fields[mStartPoint.x - idx + (mStartPoint.y) * mBoard.size()];
+bool Row::insertSkyscraper(std::size_t idx, int skyscraper)
+{
+    Field field;
+    field.insertSkyscraper(skyscraper);
+    return setField(idx, field);
 }
@@ -1,33 +1,44 @@
 #ifndef ROW_H
 #define ROW_H
 
+#include "../shared/bitmask.h"
 #include "../shared/point.h"
 #include "../shared/readdirection.h"
+#include "../shared/rowkernels.h"
 
-#include <optional>
+#include <cstdint>
+#include <limits>
 #include <vector>
 
 class Field;
 class Board;
+struct RowCounters;
 
 class Row {
 public:
     Row(Board &board, const Point &startPoint,
         const ReadDirection &readDirection);
 
-    void addCrossingRows(Row *crossingRow);
+    // all functions which change fields propagate the changes over the
+    // board and return false if it ends up with a contradiction
 
     bool hasOnlyOneNopeField() const;
-    void addLastMissingSkyscraper();
+    bool addLastMissingSkyscraper();
 
-    void addNopesToAllNopeFields(int nope);
+    bool addNopesToAllNopeFields(int nope);
+
+    // places skyscraper on field idx without asking if it fits
+    bool addSkyscraper(std::size_t idx, int skyscraper);
 
     bool allFieldsContainSkyscraper() const;
 
     int skyscraperCount() const;
     int nopeCount(int nope) const;
 
-    void guessSkyscraperOutOfNeighbourNopes();
+    // changes whenever a field of the row changes
+    std::uint64_t epoch() const;
+
+    bool guessSkyscraperOutOfNeighbourNopes();
 
     enum class Direction { front, back };
 
@@ -36,10 +47,26 @@ public:
     bool hasNopes(const std::vector<std::vector<int>> &nopes,
                   Direction direction) const;
 
-    void addFieldData(const std::vector<Field> &fieldData, Direction direction);
+    bool addFieldData(const std::vector<Field> &fieldData, Direction direction);
+    // bitmasks of all fields from the front, applied in one step. Only the
+    // values up to the board size are used
+    bool addFieldData(const RowMasks &fieldData);
 
     const Field &getFieldRef(std::size_t idx) const;
-    Field &getFieldRef(std::size_t idx);
+
+    // bitmasks of all fields from the front
+    RowMasks fieldMasks() const;
+
+    // clues of the row seen from the front, 0 stands for a missing clue
+    void setClues(int front, int back);
+
+    // called by the board for the events queued for this row. Removes new
+    // skyscrapers from the other fields and places values which fit into
+    // only one field anymore. A row with clues drops values which break
+    // the bounds of the clues and keeps only values which are part of a
+    // permutation fitting to the clues. The board queues the events of these
+    // changes. Stops at the first contradiction
+    bool propagate(BitmaskType skyscrapers, BitmaskType removedValues);
 
 private:
     template <typename SkyIterator>
@@ -49,32 +76,49 @@ private:
     bool hasNopes(NopesIterator nopesItBegin, NopesIterator nopesItEnd) const;
 
     template <typename FieldDataIterator>
-    void addFieldData(FieldDataIterator fieldDataItBegin,
+    bool addFieldData(FieldDataIterator fieldDataItBegin,
                       FieldDataIterator fieldDataItEnd);
 
-    void insertFieldData(std::size_t idx, const Field &fieldData);
-
-    void insertSkyscraperNeighbourHandling(std::size_t idx, int skyscraper);
+    // all fields of the row are changed at once
+    bool insertFieldData(RowMasks fieldData);
 
-    void insertNopesNeighbourHandling(std::size_t idx, int nopes,
-                                      bool hadSkyscraperBefore);
+    bool addNopesToAllNopeFields(BitmaskType nopes);
 
-    bool onlyOneFieldWithoutNope(int nope) const;
+    bool insertSkyscrapersWithOnlyOneField(BitmaskType values);
 
-    bool nopeExistsAsSkyscraperInFields(int nope) const;
+    // cheap bounds of the clues on the values of the fields out of the
+    // fields which are surely visible or hidden. Also for rows which are too
+    // big for insertLineSolution()
+    bool insertClueBounds();
 
-    std::optional<int> nopeValueInAllButOneField() const;
+    // exact values of all fields for the clues out of solveLine(), through
+    // the LineSolverCache of the thread
+    bool insertLineSolution();
 
-    void insertSkyscraperToFirstFieldWithoutNope(int nope);
+    BitmaskType placedSkyscrapers() const;
 
-    bool hasSkyscraper(int skyscraper) const;
+    std::size_t boardIdx(std::size_t idx) const;
 
-    // Field &getFieldRef(std::size_t idx);
+    bool setField(std::size_t idx, const Field &field);
+    bool insertSkyscraper(std::size_t idx, int skyscraper);
 
     Board &mBoard;
     Point mStartPoint;
     ReadDirection mReadDirection;
-    std::vector<Row *> mCrossingRows;
+
+    // columns are read forward out of the column major fields and rows
+    // backwards out of the row major fields. Both are contiguous so there is
+    // no need to check the read direction on every access
+    const Field *mFirstField;
+    std::ptrdiff_t mFieldStep;
+    std::size_t mFirstBoardIdx;
+    std::ptrdiff_t mBoardIdxStep;
+    const RowCounters *mCounters;
+
+    int mFrontClue{0};
+    int mBackClue{0};
+    // epoch of the fields at the last insertLineSolution()
+    std::uint64_t mLineSolvedEpoch{std::numeric_limits<std::uint64_t>::max()};
 };
 
 #endif
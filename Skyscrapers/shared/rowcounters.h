@@ -0,0 +1,30 @@
+#ifndef ROWCOUNTERS_H
+#define ROWCOUNTERS_H
+
+#include "bitmask.h"
+
+#include <array>
+#include <cstdint>
+
+// Kept up to date by Board on every change of a field so a Row can answer
+// how many skyscrapers it has or where a value can still go without
+// scanning its fields. Counts of a value are at [value - 1].
+struct RowCounters {
+    // skyscrapers placed in the row
+    BitmaskType skyscrapers{};
+    int skyscraperCount{0};
+    // only more than one if the board is invalid but then skyscrapers must
+    // not lose the value when one of the duplicates gets removed again
+    std::array<int, maxBoardSize> skyscraperCounts{};
+
+    // fields which still contain the value, fields with a skyscraper
+    // included
+    std::array<int, maxBoardSize> candidateCounts{};
+    // values which are in candidateCounts exactly once
+    BitmaskType singleCandidates{};
+
+    // increased on every change of a field in the row, also on a rollback
+    std::uint64_t epoch{0};
+};
+
+#endif
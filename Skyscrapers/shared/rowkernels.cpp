@@ -0,0 +1,136 @@
+#include "rowkernels.h"
+
+#include <cassert>
+
+#if SKYSCRAPERS_MAX_BOARD_SIZE <= 16
+#if defined(__AVX2__)
+#define SKYSCRAPERS_ROWKERNELS_AVX2
+#include <immintrin.h>
+#elif defined(__SSE4_1__)
+#define SKYSCRAPERS_ROWKERNELS_SSE4
+#include <smmintrin.h>
+#endif
+#endif
+
+namespace {
+
+#if defined(SKYSCRAPERS_ROWKERNELS_AVX2)
+
+__m256i load(const RowMasks &masks)
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(masks.data()));
+}
+
+void store(RowMasks &masks, __m256i lanes)
+{
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(masks.data()), lanes);
+}
+
+// lanes which are 0xffff or 0 to one bit per lane
+BitmaskType laneBits(__m256i lanes)
+{
+    auto packed = _mm_packs_epi16(_mm256_castsi256_si128(lanes),
+                                  _mm256_extracti128_si256(lanes, 1));
+    return static_cast<BitmaskType>(_mm_movemask_epi8(packed));
+}
+
+#elif defined(SKYSCRAPERS_ROWKERNELS_SSE4)
+
+// lanes 0 - 7 and 8 - 15
+struct Lanes {
+    __m128i low;
+    __m128i high;
+};
+
+Lanes load(const RowMasks &masks)
+{
+    auto data = reinterpret_cast<const __m128i *>(masks.data());
+    return {_mm_loadu_si128(data), _mm_loadu_si128(data + 1)};
+}
+
+void store(RowMasks &masks, const Lanes &lanes)
+{
+    auto data = reinterpret_cast<__m128i *>(masks.data());
+    _mm_storeu_si128(data, lanes.low);
+    _mm_storeu_si128(data + 1, lanes.high);
+}
+
+// lanes which are 0xffff or 0 to one bit per lane
+BitmaskType laneBits(const Lanes &lanes)
+{
+    return static_cast<BitmaskType>(
+        _mm_movemask_epi8(_mm_packs_epi16(lanes.low, lanes.high)));
+}
+
+#endif
+
+} // namespace
+
+BitmaskType intersectMasks(RowMasks &masks, const RowMasks &other,
+                           std::size_t size)
+{
+    assert(size <= maxBoardSize);
+
+#if defined(SKYSCRAPERS_ROWKERNELS_AVX2)
+    auto lanes = load(masks);
+    auto result = _mm256_and_si256(lanes, load(other));
+    store(masks, result);
+    auto unchanged = _mm256_cmpeq_epi16(lanes, result);
+    return static_cast<BitmaskType>(~laneBits(unchanged) & fullBitmask(size));
+#elif defined(SKYSCRAPERS_ROWKERNELS_SSE4)
+    auto lanes = load(masks);
+    auto otherLanes = load(other);
+    Lanes result{_mm_and_si128(lanes.low, otherLanes.low),
+                 _mm_and_si128(lanes.high, otherLanes.high)};
+    store(masks, result);
+    Lanes unchanged{_mm_cmpeq_epi16(lanes.low, result.low),
+                    _mm_cmpeq_epi16(lanes.high, result.high)};
+    return static_cast<BitmaskType>(~laneBits(unchanged) & fullBitmask(size));
+#else
+    BitmaskType changed{};
+    for (std::size_t lane = 0; lane < size; ++lane) {
+        auto result = masks[lane] & other[lane];
+        if (result != masks[lane]) {
+            masks[lane] = result;
+            changed |= laneBitmask(lane);
+        }
+    }
+    return changed;
+#endif
+}
+
+BitmaskType singleBitLanes(const RowMasks &masks, std::size_t size)
+{
+    assert(size <= maxBoardSize);
+
+#if defined(SKYSCRAPERS_ROWKERNELS_AVX2)
+    auto lanes = load(masks);
+    auto zero = _mm256_setzero_si256();
+    auto withoutLowestBit =
+        _mm256_and_si256(lanes, _mm256_sub_epi16(lanes, _mm256_set1_epi16(1)));
+    auto single =
+        _mm256_andnot_si256(_mm256_cmpeq_epi16(lanes, zero),
+                            _mm256_cmpeq_epi16(withoutLowestBit, zero));
+    return static_cast<BitmaskType>(laneBits(single) & fullBitmask(size));
+#elif defined(SKYSCRAPERS_ROWKERNELS_SSE4)
+    auto lanes = load(masks);
+    auto zero = _mm_setzero_si128();
+    auto one = _mm_set1_epi16(1);
+    auto isSingle = [&](__m128i half) {
+        auto withoutLowestBit = _mm_and_si128(half, _mm_sub_epi16(half, one));
+        return _mm_andnot_si128(_mm_cmpeq_epi16(half, zero),
+                                _mm_cmpeq_epi16(withoutLowestBit, zero));
+    };
+    return static_cast<BitmaskType>(
+        laneBits({isSingle(lanes.low), isSingle(lanes.high)}) &
+        fullBitmask(size));
+#else
+    BitmaskType singles{};
+    for (std::size_t lane = 0; lane < size; ++lane) {
+        if (hasSingleBit(masks[lane])) {
+            singles |= laneBitmask(lane);
+        }
+    }
+    return singles;
+#endif
+}
@@ -0,0 +1,36 @@
+#ifndef ROWKERNELS_H
+#define ROWKERNELS_H
+
+#include "bitmask.h"
+
+#include <array>
+#include <cstddef>
+
+/*
+    Kernels which work on the bitmasks of all fields of a row at once.
+
+    Lane i holds the bitmask of field i. Lanes at and behind size are
+    ignored. Sets of lanes are returned as bitmask with bit i set for lane i.
+
+    With SKYSCRAPERS_MAX_BOARD_SIZE <= 16 a row fits into one AVX2 register
+    or two SSE registers. The kernels are vectorized if the compiler targets
+    AVX2 or SSE4.1, otherwise they are plain loops.
+*/
+
+constexpr std::size_t rowLanes = maxBoardSize <= 16 ? 16 : maxBoardSize;
+
+using RowMasks = std::array<BitmaskType, rowLanes>;
+
+inline BitmaskType laneBitmask(std::size_t lane)
+{
+    return valueBitmask(static_cast<int>(lane) + 1);
+}
+
+// masks &= other, returns the lanes which changed
+BitmaskType intersectMasks(RowMasks &masks, const RowMasks &other,
+                           std::size_t size);
+
+// lanes with exactly one toggled bit which means the field has a skyscraper
+BitmaskType singleBitLanes(const RowMasks &masks, std::size_t size);
+
+#endif
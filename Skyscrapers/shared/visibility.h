@@ -0,0 +1,39 @@
+#ifndef VISIBILITY_H
+#define VISIBILITY_H
+
+#include "bitmask.h"
+
+/*
+    Visible buildings are counted while a permutation is build up from the
+    front. From the front a value is visible if it is taller than all values
+    before. From the back a value is visible if it is the tallest value not
+    placed yet. 0 stands for a missing clue.
+
+    Returns false if front or back cannot be reached anymore with the
+    values which are not placed yet.
+*/
+template <typename Bitmask>
+bool cluesReachable(int front, int back, const Bitmask &unusedValues,
+                    int tallest, int frontVisible, int backVisible)
+{
+    if (front != 0) {
+        auto tallerValues = popCount(static_cast<Bitmask>(
+            unusedValues & ~fullBitmask<Bitmask>(tallest)));
+        auto minVisible = frontVisible + (tallerValues > 0 ? 1 : 0);
+        auto maxVisible = frontVisible + tallerValues;
+        if (front < minVisible || front > maxVisible) {
+            return false;
+        }
+    }
+    if (back != 0) {
+        auto remainingValues = popCount(unusedValues);
+        auto minVisible = backVisible + (remainingValues > 0 ? 1 : 0);
+        auto maxVisible = backVisible + remainingValues;
+        if (back < minVisible || back > maxVisible) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#endif